@@ -0,0 +1,211 @@
+#pragma once
+#include <Arduino.h>
+#include "GridEngine.h"
+#include "BitPlane.h"
+#include "FixedMath.h"
+
+// Diffusion-limited aggregation: random walkers wander in from outside the
+// city and stick where they first touch it, growing a fractal sprawl out
+// of downtown.
+//
+// Naive DLA spends nearly all its moves in empty space, so the engine
+// keeps a coarse distance field: for every 8x8-pixel cell, the Chebyshev
+// distance (in cells, capped) to the nearest cell holding any of the
+// cluster. A walker d cells away can't touch the cluster within
+// (d - 1) * 8 pixels, so it jumps that far in a random direction in one
+// move. Only walkers next to the cluster take single-pixel steps. When a
+// pixel attaches in a cell that was empty, the field is lowered around it,
+// a fixed-size square of updates. Walkers launch just outside the cluster's
+// bounding radius and are relaunched if they stray too far. A walker that
+// ends a move touching the cluster sticks there; one that lands on it
+// (a neighbour attached where it stood) is relaunched instead. Once the
+// radius covers the whole screen there is nowhere left to launch from and
+// the engine reports finished().
+class Aggregation : public GridEngine {
+public:
+  Aggregation(uint16_t w, uint16_t h)
+  : GridEngine(w, h), CW((w + CELL - 1) >> CELL_SHIFT), CH((h + CELL - 1) >> CELL_SHIFT) {
+    cluster.init(w, h);
+    dist = (uint8_t*)malloc((size_t)CW * CH);
+  }
+
+  ~Aggregation() {
+    if (dist) free(dist);
+  }
+
+  bool valid() const { return GridEngine::valid() && cluster.valid() && dist; }
+
+  void reset(uint32_t seed) {
+    if (!valid()) return;
+    seedRandom(seed);
+    clearGrid();
+    cluster.clearAll();
+    memset(dist, DIST_CAP, (size_t)CW * CH);
+
+    seedX = W / 2;
+    seedY = H / 2;
+    radius = 0;
+    attachCount = 0;
+    districts.addSite(seedX, seedY);
+    attach(seedX, seedY);
+    for (uint8_t i = 0; i < WALKERS; i++) launch(walkers[i]);
+    next = 0;
+  }
+
+  void step() {
+    if (done) return;
+    for (uint16_t m = 0; m < MOVES_PER_STEP; m++) {
+      Walker &k = walkers[next];
+      next = (next + 1) % WALKERS;
+      move(k);
+    }
+  }
+
+  // Bench metric: pixels attached since reset
+  const char *metricName() const { return "attaches"; }
+  uint32_t metricCount() const { return attachCount; }
+
+private:
+  struct Walker { int16_t x, y; bool live; };
+
+  static constexpr uint8_t  CELL_SHIFT = 3;          // distance cell = 8x8 px
+  static constexpr uint8_t  CELL = 1 << CELL_SHIFT;
+  static constexpr uint8_t  DIST_CAP = 16;           // cells; "far away"
+  static constexpr uint8_t  WALKERS = 24;
+  static constexpr uint16_t MOVES_PER_STEP = 256;    // shared by all walkers
+  static constexpr int16_t  LAUNCH_GAP = 6;          // px outside the radius
+  static constexpr int16_t  KILL_GAP = 40;           // px before relaunching
+  static constexpr uint8_t  TRIES = 8;
+
+  void move(Walker &k) {
+    if (!k.live) {
+      launch(k);
+      return;
+    }
+    uint8_t d = distAt(k.x, k.y);
+
+    if (d >= 2) {
+      // clear of the cluster for (d - 1) cells: jump
+      int32_t r = (int32_t)(d - 1) * CELL;
+      uint8_t a = rand32();
+      k.x += (int16_t)((int32_t)icos8(a) * r / 256);
+      k.y += (int16_t)((int32_t)isin8(a) * r / 256);
+    } else {
+      switch (rand32() & 3) {
+        case 0: k.x++; break;
+        case 1: k.y++; break;
+        case 2: k.x--; break;
+        default: k.y--; break;
+      }
+    }
+
+    if (k.x < 1 || k.y < 1 || k.x >= (int16_t)W - 1 || k.y >= (int16_t)H - 1 || strayed(k)) {
+      launch(k);
+      return;
+    }
+
+    // only cells within one of the cluster can hold a pixel next to it
+    if (cluster.test(k.x, k.y)) {
+      launch(k);
+    } else if (distAt(k.x, k.y) < 2 && touching(k.x, k.y)) {
+      attach(k.x, k.y);
+      launch(k);
+    }
+  }
+
+  uint8_t distAt(int16_t x, int16_t y) const {
+    return dist[(y >> CELL_SHIFT) * CW + (x >> CELL_SHIFT)];
+  }
+
+  bool strayed(const Walker &k) const {
+    int32_t dx = k.x - seedX, dy = k.y - seedY;
+    int32_t lim = radius + KILL_GAP;
+    return dx * dx + dy * dy > lim * lim;
+  }
+
+  bool touching(int16_t x, int16_t y) const {
+    for (int8_t dy = -1; dy <= 1; dy++) {
+      for (int8_t dx = -1; dx <= 1; dx++) {
+        if ((dx || dy) && cluster.test(x + dx, y + dy)) return true;
+      }
+    }
+    return false;
+  }
+
+  // On the launch circle if it's on screen, else on the screen's edge
+  // outside it (the city has outgrown the screen in that direction). If
+  // neither turns up a spot the walker sits out until its next move.
+  void launch(Walker &k) {
+    int32_t r = radius + LAUNCH_GAP;
+    k.live = false;
+    if (!outsideOnScreen(r)) {
+      done = true;
+      return;
+    }
+    for (uint8_t t = 0; t < TRIES; t++) {
+      uint8_t a = rand32();
+      int16_t x, y;
+      if (t < TRIES / 2) {
+        x = seedX + (int16_t)((int32_t)icos8(a) * r / 256);
+        y = seedY + (int16_t)((int32_t)isin8(a) * r / 256);
+      } else {
+        // the screen's edge, where what's left outside the circle is
+        uint32_t e = rand32();
+        x = (e & 1) ? 1 + (e >> 2) % (W - 2) : ((e & 2) ? W - 2 : 1);
+        y = (e & 1) ? ((e & 2) ? H - 2 : 1) : 1 + (e >> 2) % (H - 2);
+      }
+      if (x < 1 || y < 1 || x >= (int16_t)W - 1 || y >= (int16_t)H - 1) continue;
+      int32_t dx = x - seedX, dy = y - seedY;
+      if (dx * dx + dy * dy <= radius * radius) continue;
+      if (cluster.test(x, y) || touching(x, y)) continue;
+      k.x = x;
+      k.y = y;
+      k.live = true;
+      return;
+    }
+  }
+
+  // Is any of the screen (inside the 1 px border) r or more from the seed?
+  bool outsideOnScreen(int32_t r) const {
+    int32_t dx = max<int32_t>(seedX - 1, (int32_t)W - 2 - seedX);
+    int32_t dy = max<int32_t>(seedY - 1, (int32_t)H - 2 - seedY);
+    return dx * dx + dy * dy >= r * r;
+  }
+
+  void attach(int16_t x, int16_t y) {
+    cluster.set(x, y);
+    // downtown bright, newer sprawl dimmer
+    addIntensity(x, y, (uint8_t)max<int32_t>(70, 230 - (int32_t)(attachCount / 24)));
+    attachCount++;
+
+    int32_t dx = x - seedX, dy = y - seedY;
+    while ((radius + 1) * (radius + 1) <= dx * dx + dy * dy) radius++;
+
+    uint16_t cx = x >> CELL_SHIFT, cy = y >> CELL_SHIFT;
+    if (dist[cy * CW + cx]) lowerDistance(cx, cy);
+  }
+
+  // Cell (cx, cy) just got its first cluster pixel
+  void lowerDistance(uint16_t cx, uint16_t cy) {
+    for (int16_t dy = -(DIST_CAP - 1); dy <= DIST_CAP - 1; dy++) {
+      int16_t y = cy + dy;
+      if (y < 0 || y >= (int16_t)CH) continue;
+      uint8_t *row = dist + y * CW;
+      for (int16_t dx = -(DIST_CAP - 1); dx <= DIST_CAP - 1; dx++) {
+        int16_t x = cx + dx;
+        if (x < 0 || x >= (int16_t)CW) continue;
+        uint8_t d = max(abs(dx), abs(dy));
+        if (d < row[x]) row[x] = d;
+      }
+    }
+  }
+
+  const uint16_t CW, CH;
+  BitPlane cluster;              // attached pixels
+  uint8_t *dist = nullptr;       // per cell, 0..DIST_CAP
+  Walker walkers[WALKERS];
+  uint8_t next = 0;
+  int16_t seedX = 0, seedY = 0;
+  int32_t radius = 0;            // bounding radius of the cluster, px
+  uint32_t attachCount = 0;
+};
@@ -0,0 +1,209 @@
+#pragma once
+#include <Arduino.h>
+#include "FixedMath.h"
+#include "Engines.h"
+#include "Zoning.h"
+
+// On-device micro-benchmarks, printed over serial ('b' in the console).
+// Timings are wall-clock micros() on whatever core runs loop(). The same
+// functions build on the host in test/host/bench_host.cpp.
+
+namespace bench {
+
+static inline void satAdd(uint8_t *g, uint32_t idx, uint8_t amt) {
+  uint16_t v = g[idx] + amt;
+  g[idx] = (v > 255) ? 255 : (uint8_t)v;
+}
+
+// Per-agent cost of the motion + road deposit kernel: the old integer
+// 4-direction stepping vs 16.16 fixed-point headings with a bilinear 2x2
+// deposit. Both run on a scratch grid with the same agent count.
+static void agentMotion(uint16_t W, uint16_t H) {
+  static constexpr uint8_t  AGENTS = 60;
+  static constexpr uint16_t ITERS  = 2000;
+
+  uint8_t *g = (uint8_t*)malloc((size_t)W * H);
+  if (!g) { Serial.println("bench: no memory"); return; }
+  memset(g, 0, (size_t)W * H);
+
+  struct IntAgent { int16_t x, y; int8_t dx, dy; };
+  struct FixAgent { int32_t x, y; uint8_t heading; };
+  IntAgent ia[AGENTS];
+  FixAgent fa[AGENTS];
+  for (uint8_t i = 0; i < AGENTS; i++) {
+    ia[i] = IntAgent{(int16_t)(W / 2), (int16_t)(H / 2), (int8_t)((i & 1) ? 1 : 0), (int8_t)((i & 1) ? 0 : 1)};
+    fa[i] = FixAgent{(int32_t)(W / 2) << 16, (int32_t)(H / 2) << 16, (uint8_t)(i * 37)};
+  }
+
+  uint32_t t0 = micros();
+  for (uint16_t it = 0; it < ITERS; it++) {
+    for (uint8_t i = 0; i < AGENTS; i++) {
+      IntAgent &a = ia[i];
+      satAdd(g, (uint32_t)a.y * W + a.x, 35);
+      a.x += a.dx;
+      a.y += a.dy;
+      if (a.x < 1 || a.x >= (int16_t)W - 1 || a.y < 1 || a.y >= (int16_t)H - 1) {
+        a.x = constrain(a.x, 1, (int16_t)W - 2);
+        a.y = constrain(a.y, 1, (int16_t)H - 2);
+        a.dx = -a.dx;
+        a.dy = -a.dy;
+      }
+    }
+  }
+  uint32_t intUs = micros() - t0;
+
+  const int32_t maxX = (int32_t)(W - 2) << 16, maxY = (int32_t)(H - 2) << 16;
+  t0 = micros();
+  for (uint16_t it = 0; it < ITERS; it++) {
+    for (uint8_t i = 0; i < AGENTS; i++) {
+      FixAgent &a = fa[i];
+      int16_t ix = a.x >> 16, iy = a.y >> 16;
+      uint16_t fx = (a.x >> 8) & 0xFF, fy = (a.y >> 8) & 0xFF;
+      uint16_t w11 = (fx * fy) >> 8;
+      uint32_t idx = (uint32_t)iy * W + ix;
+      satAdd(g, idx,         (35 * (256 - fx - fy + w11)) >> 8);
+      satAdd(g, idx + 1,     (35 * (fx - w11)) >> 8);
+      satAdd(g, idx + W,     (35 * (fy - w11)) >> 8);
+      satAdd(g, idx + W + 1, (35 * w11) >> 8);
+      a.heading += 1;
+      a.x += (int32_t)icos8(a.heading) * 256;
+      a.y += (int32_t)isin8(a.heading) * 256;
+      if (a.x < (1 << 16) || a.x > maxX || a.y < (1 << 16) || a.y > maxY) {
+        a.x = constrain(a.x, (int32_t)1 << 16, maxX);
+        a.y = constrain(a.y, (int32_t)1 << 16, maxY);
+        a.heading += 128;
+      }
+    }
+  }
+  uint32_t fixUs = micros() - t0;
+
+  uint32_t n = (uint32_t)AGENTS * ITERS;
+  Serial.printf("agent step: integer %lu ns, fixed-point AA %lu ns (checksum %u)\n",
+                (unsigned long)(intUs * 1000UL / n), (unsigned long)(fixUs * 1000UL / n),
+                g[(H / 2) * W + W / 2]);
+  free(g);
+}
+
+// One zoning generation over the whole grid: a byte-per-cell CA counting
+// neighbours cell by cell vs the bit-sliced Zoning layer, from the same
+// random start. The two must agree cell for cell.
+static void zoning(uint16_t W, uint16_t H) {
+  static constexpr uint8_t GENS = 20;
+
+  Zoning z;
+  BitPlane water;
+  uint8_t *a = (uint8_t*)malloc((size_t)W * H);
+  uint8_t *b = (uint8_t*)malloc((size_t)W * H);
+  if (!z.init(W, H) || !water.init(W, H) || !a || !b) {
+    Serial.println("bench: no memory");
+    if (a) free(a);
+    if (b) free(b);
+    return;
+  }
+
+  // mostly served, a little water, zones sprinkled at ~1 in 3
+  uint32_t rng = 0x2545F491u;
+  auto next = [&]() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; };
+  for (uint16_t y = 0; y < H; y++) {
+    for (uint16_t x = 0; x < W; x++) {
+      uint32_t r = next();
+      if ((r & 15) < 13 && !(x % 4) && !(y % 4)) z.markRoad(x, y);
+      if (((r >> 4) & 63) == 0) water.set(x, y);
+      uint8_t zone = ((r >> 10) % 3) ? (uint8_t)Zoning::ZONE_NONE : 1 + (r >> 12) % 3;
+      z.seed(x, y, zone, 0);
+      a[(uint32_t)y * W + x] = zone;
+    }
+  }
+
+  uint32_t t0 = micros();
+  for (uint8_t g = 0; g < GENS; g++) {
+    for (uint16_t y = 0; y < H; y++) {
+      for (uint16_t x = 0; x < W; x++) {
+        uint8_t n[Zoning::ZONES] = {};
+        for (int8_t dy = -1; dy <= 1; dy++) {
+          for (int8_t dx = -1; dx <= 1; dx++) {
+            int16_t nx = x + dx, ny = y + dy;
+            if ((!dx && !dy) || nx < 0 || ny < 0 || nx >= (int16_t)W || ny >= (int16_t)H) continue;
+            n[a[(uint32_t)ny * W + nx]]++;
+          }
+        }
+        b[(uint32_t)y * W + x] = Zoning::rule(a[(uint32_t)y * W + x],
+            n[Zoning::ZONE_RES], n[Zoning::ZONE_COM], n[Zoning::ZONE_IND],
+            z.servedPlane().test(x, y), water.test(x, y));
+      }
+    }
+    uint8_t *t = a; a = b; b = t;
+  }
+  uint32_t byteUs = micros() - t0;
+
+  t0 = micros();
+  for (uint8_t g = 0; g < GENS; g++) z.step(&water);
+  uint32_t bitUs = micros() - t0;
+
+  uint32_t diff = 0;
+  for (uint16_t y = 0; y < H; y++) {
+    for (uint16_t x = 0; x < W; x++) diff += z.at(x, y) != a[(uint32_t)y * W + x];
+  }
+  Serial.printf("zoning CA: byte %lu us/gen, bit-sliced %lu us/gen (%s)\n",
+                (unsigned long)(byteUs / GENS), (unsigned long)(bitUs / GENS),
+                diff ? "MISMATCH" : "match");
+  free(a);
+  free(b);
+}
+
+// Engines may expose their own figure of merit as metricName() and
+// metricCount(); the bench prints it per second of the run
+template <class E>
+static auto printMetric(E &e, uint32_t us, int) -> decltype(e.metricName(), void()) {
+  Serial.printf("  %lu %s/s\n", (unsigned long)(us ? (uint64_t)e.metricCount() * 1000000ULL / us : 0),
+                e.metricName());
+}
+template <class E>
+static void printMetric(E &, uint32_t, long) {}
+
+// Engines with a road graph also report how connected the network is, and
+// how often its incremental update had to fall back to a rebuild
+template <class E>
+static auto printNetwork(E &e, int) -> decltype(e.roadGraph(), void()) {
+  const RoadGraph &g = e.roadGraph();
+  Serial.printf("  road network: %u parts, largest %u blocks, %lu full rebuilds\n",
+                (unsigned)g.componentCount(), (unsigned)g.largestComponent(),
+                (unsigned long)g.fallbackRebuilds());
+}
+template <class E>
+static void printNetwork(E &, long) {}
+
+// Every engine in CITY_ENGINES: steps/sec while it is still growing (steps
+// after finished() are no-ops and would only dilute the figure), plus the
+// grid hash after the full fixed run, checked against its golden value.
+// Leaves the host on the last engine; the caller reselects what it wants.
+static void engines(EngineHost &host, uint16_t W, uint16_t H) {
+  for (uint8_t id = 0; id < ENGINE_COUNT; id++) {
+    if (!host.select(id, W, H, ENGINE_BENCH_SEED)) {
+      Serial.printf("%s: no memory\n", ENGINE_NAMES[id]);
+      continue;
+    }
+    uint16_t grown = 0;
+    uint32_t t0 = micros();
+    while (grown < ENGINE_BENCH_STEPS && !host.grid().finished()) {
+      host.stepN(1);
+      grown++;
+    }
+    uint32_t us = micros() - t0;
+    host.stepN(ENGINE_BENCH_STEPS - grown);
+
+    uint32_t h = host.grid().hash();
+    const char *verdict = !ENGINE_GOLDEN[id] ? "unrecorded"
+                        : (h == ENGINE_GOLDEN[id]) ? "ok" : "MISMATCH";
+    Serial.printf("%s: %lu steps/s, hash %08lx %s\n", ENGINE_NAMES[id],
+                  (unsigned long)(us ? (uint64_t)grown * 1000000ULL / us : 0),
+                  (unsigned long)h, verdict);
+    if (grown < ENGINE_BENCH_STEPS) Serial.printf("  finished after %u steps\n", (unsigned)grown);
+    host.dispatch([&](auto &e) {
+      printMetric(e, us, 0);
+      printNetwork(e, 0);
+    });
+  }
+}
+
+}  // namespace bench
@@ -0,0 +1,115 @@
+#pragma once
+#include <Arduino.h>
+
+// One bit per cell, rows padded to whole 32-bit words (240 wide -> 8 words
+// per row, 240x135 -> 4320 bytes). Single-cell tests are one load and a
+// shift; bulk operations work a word at a time. Padding bits stay zero.
+class BitPlane {
+public:
+  BitPlane() = default;
+  BitPlane(const BitPlane &) = delete;
+  BitPlane &operator=(const BitPlane &) = delete;
+
+  ~BitPlane() {
+    if (bits) free(bits);
+  }
+
+  bool init(uint16_t w, uint16_t h) {
+    W = w; H = h;
+    stride = (w + 31) >> 5;
+    if (bits) free(bits);
+    bits = (uint32_t*)malloc((size_t)stride * h * sizeof(uint32_t));
+    clearAll();
+    return bits != nullptr;
+  }
+
+  bool valid() const { return bits != nullptr; }
+
+  inline bool test(uint16_t x, uint16_t y) const {
+    return (bits[y * stride + (x >> 5)] >> (x & 31)) & 1;
+  }
+
+  inline void set(uint16_t x, uint16_t y) {
+    bits[y * stride + (x >> 5)] |= 1u << (x & 31);
+  }
+
+  inline void reset(uint16_t x, uint16_t y) {
+    bits[y * stride + (x >> 5)] &= ~(1u << (x & 31));
+  }
+
+  void clearAll() {
+    if (bits) memset(bits, 0, (size_t)stride * H * sizeof(uint32_t));
+  }
+
+  // Set x0..x1 (inclusive) on row y, whole words where possible
+  void setSpan(uint16_t y, int16_t x0, int16_t x1) {
+    if (x0 < 0) x0 = 0;
+    if (x1 >= (int16_t)W) x1 = W - 1;
+    if (x0 > x1) return;
+    uint32_t *r = row(y);
+    uint16_t w0 = x0 >> 5, w1 = x1 >> 5;
+    uint32_t m0 = ~0u << (x0 & 31);
+    uint32_t m1 = ~0u >> (31 - (x1 & 31));
+    if (w0 == w1) { r[w0] |= m0 & m1; return; }
+    r[w0] |= m0;
+    for (uint16_t w = w0 + 1; w < w1; w++) r[w] = ~0u;
+    r[w1] |= m1;
+  }
+
+  uint32_t count() const {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < (uint32_t)stride * H; i++) n += __builtin_popcount(bits[i]);
+    return n;
+  }
+
+  // Calls fn(x, y) for every set bit, skipping empty words
+  template <class Fn>
+  void forEachSet(Fn fn) const {
+    for (uint16_t y = 0; y < H; y++) {
+      const uint32_t *r = row(y);
+      for (uint16_t w = 0; w < stride; w++) {
+        uint32_t m = r[w];
+        while (m) {
+          uint8_t b = __builtin_ctz(m);
+          fn((uint16_t)((w << 5) + b), y);
+          m &= m - 1;
+        }
+      }
+    }
+  }
+
+  // out = cells of this plane with at least one 4-neighbour outside it.
+  // Cells beyond the grid count as outside.
+  void edges(BitPlane &out) const {
+    for (uint16_t y = 0; y < H; y++) {
+      const uint32_t *r  = row(y);
+      const uint32_t *up = y > 0 ? row(y - 1) : nullptr;
+      const uint32_t *dn = y + 1 < H ? row(y + 1) : nullptr;
+      uint32_t *o = out.row(y);
+      for (uint16_t w = 0; w < stride; w++) {
+        uint32_t c = r[w];
+        uint32_t prev = w > 0 ? r[w - 1] : 0;
+        uint32_t next = w + 1 < stride ? r[w + 1] : 0;
+        uint32_t left  = (c << 1) | (prev >> 31);   // neighbour at x-1
+        uint32_t right = (c >> 1) | (next << 31);   // neighbour at x+1
+        uint32_t inner = c & left & right & (up ? up[w] : 0) & (dn ? dn[w] : 0);
+        o[w] = c & ~inner & lastWordMask(w);
+      }
+    }
+  }
+
+  uint32_t *row(uint16_t y) { return bits + (uint32_t)y * stride; }
+  const uint32_t *row(uint16_t y) const { return bits + (uint32_t)y * stride; }
+  uint16_t wordsPerRow() const { return stride; }
+  uint16_t width()  const { return W; }
+  uint16_t height() const { return H; }
+
+private:
+  uint32_t lastWordMask(uint16_t w) const {
+    if (w + 1 < stride || (W & 31) == 0) return ~0u;
+    return (1u << (W & 31)) - 1;
+  }
+
+  uint16_t W = 0, H = 0, stride = 0;
+  uint32_t *bits = nullptr;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <Arduino.h>
+
+// Burn-in protection that keeps the city.
+//
+// Orbit: the picture is drawn shifted by a whole-pixel offset that walks a
+// small diamond (at most 2 px from centre), one step every ORBIT_MS, so
+// static edges never sit on the same pixels for long. The shift is applied
+// where intensities are converted to colour (screen pixel = grid pixel +
+// offset), so it costs nothing per frame; a step just recolors the screen
+// once, like a palette change.
+//
+// Dim: after DIM_AFTER_MS without a button or serial key the brightness
+// ramps down to DIM_FLOOR over DIM_RAMP_MS, in DIM_LEVELS steps so the
+// LUTs are rebuilt only a handful of times. Any input brings it back.
+class BurnInGuard {
+public:
+  static constexpr uint32_t ORBIT_MS = 90UL * 1000;
+  static constexpr uint32_t DIM_AFTER_MS = 10UL * 60 * 1000;
+  static constexpr uint32_t DIM_RAMP_MS = 30UL * 60 * 1000;
+  static constexpr uint16_t DIM_FLOOR = 144;   // Q8, ~56%
+  static constexpr uint8_t  DIM_LEVELS = 8;
+
+  void start(uint32_t nowMs) {
+    orbitMs = inputMs = nowMs;
+  }
+
+  void setEnabled(bool on) {
+    enabled = on;
+    if (!on) level = DIM_LEVELS;
+  }
+  bool isEnabled() const { return enabled; }
+
+  // A button or key was pressed
+  void wake(uint32_t nowMs) { inputMs = nowMs; }
+
+  // Advance the orbit and dimming; true if the offset or brightness changed
+  bool update(uint32_t nowMs) {
+    if (!enabled) return false;
+    bool changed = false;
+
+    if (nowMs - orbitMs >= ORBIT_MS) {
+      orbitMs = nowMs;
+      pos = (pos + 1) % ORBIT_POINTS;
+      changed = true;
+    }
+
+    // DIM_LEVELS = full brightness, 0 = DIM_FLOOR
+    uint32_t idle = nowMs - inputMs;
+    uint8_t l = DIM_LEVELS;
+    if (idle > DIM_AFTER_MS) {
+      uint32_t into = min<uint32_t>(idle - DIM_AFTER_MS, DIM_RAMP_MS);
+      l = DIM_LEVELS - (uint8_t)((uint64_t)into * DIM_LEVELS / DIM_RAMP_MS);
+    }
+    if (l != level) { level = l; changed = true; }
+    return changed;
+  }
+
+  // Screen pixel = grid pixel + offset
+  int8_t offsetX() const { return enabled ? ORBIT[pos][0] : 0; }
+  int8_t offsetY() const { return enabled ? ORBIT[pos][1] : 0; }
+
+  // Q8 brightness for the palette
+  uint16_t dim() const {
+    return DIM_FLOOR + (uint16_t)((256 - DIM_FLOOR) * level / DIM_LEVELS);
+  }
+
+private:
+  static constexpr uint8_t ORBIT_POINTS = 8;
+  static constexpr int8_t ORBIT[ORBIT_POINTS][2] = {
+    {2, 0}, {1, 1}, {0, 2}, {-1, 1}, {-2, 0}, {-1, -1}, {0, -2}, {1, -1},
+  };
+
+  bool enabled = true;
+  uint8_t pos = 0;
+  uint8_t level = DIM_LEVELS;
+  uint32_t orbitMs = 0, inputMs = 0;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <Arduino.h>
+
+// Compact, de-duplicated list of changed cell indices. A bit per cell says
+// whether the cell is already listed, so add() is O(1) and a cell changed
+// many times appears once. If the list fills up (or a whole-grid change
+// happens) it just flags overflow and the consumer falls back to a full pass.
+class ChangeList {
+public:
+  ChangeList() = default;
+  ChangeList(const ChangeList &) = delete;
+  ChangeList &operator=(const ChangeList &) = delete;
+
+  ~ChangeList() {
+    if (items) free(items);
+    if (listed) free(listed);
+  }
+
+  bool init(uint32_t cells, uint16_t capacity) {
+    cellCount = cells;
+    cap = capacity;
+    items = (uint16_t*)malloc((size_t)cap * sizeof(uint16_t));
+    listed = (uint32_t*)malloc(((cells + 31) >> 5) * sizeof(uint32_t));
+    clear();
+    return valid();
+  }
+
+  bool valid() const { return items && listed; }
+
+  inline void add(uint16_t idx) {
+    uint32_t &w = listed[idx >> 5];
+    uint32_t bit = 1u << (idx & 31);
+    if (w & bit) return;
+    if (count >= cap) { over = true; return; }
+    w |= bit;
+    items[count++] = idx;
+  }
+
+  // Swap-remove entry i (not the cell index); the last entry moves to i
+  inline void removeAt(uint16_t i) {
+    uint16_t idx = items[i];
+    listed[idx >> 5] &= ~(1u << (idx & 31));
+    items[i] = items[--count];
+  }
+
+  void clear() {
+    count = 0;
+    over = false;
+    if (listed) memset(listed, 0, ((cellCount + 31) >> 5) * sizeof(uint32_t));
+  }
+
+  void setOverflow() { over = true; }
+  bool overflowed() const { return over; }
+
+  uint16_t size() const { return count; }
+  uint16_t at(uint16_t i) const { return items[i]; }
+
+private:
+  uint16_t *items = nullptr;
+  uint32_t *listed = nullptr;
+  uint32_t cellCount = 0;
+  uint16_t cap = 0;
+  uint16_t count = 0;
+  bool over = false;
+};
@@ -1,41 +1,130 @@
 #pragma once
 #include <Arduino.h>
-
+#include "GridEngine.h"
+#include "BitPlane.h"
+#include "RoadGraph.h"
+#include "Zoning.h"
+#include "SteerField.h"
+#include "LandValue.h"
+#include "FixedMath.h"
+
+// The road graph (RoadGraph.h, ~17 KB of RAM) is only read by the bench
+// and the host tests, so device builds leave it out unless asked for with
+// -D CITY_ROAD_GRAPH=1
+#ifndef CITY_ROAD_GRAPH
+#define CITY_ROAD_GRAPH 0
+#endif
+
+// Position is 16.16 fixed point in grid cells; heading is an 8-bit angle
+// (0 = east, 64 = south, 256 = full turn). curve is added to heading every
+// step, so a non-zero value traces a smooth arc.
 struct Agent {
-  int16_t x, y;
-  int8_t  dx, dy;
+  int32_t x, y;
+  uint8_t heading;
+  int8_t  curve;
   uint8_t life;
 };
 
-class CitySim {
+// Agent classes. Each class is a compile-time policy: CitySim keeps agents
+// grouped by class and runs one specialised loop per group, so there is no
+// per-agent type check in step().
+enum AgentClass : uint8_t {
+  AGENT_STREET = 0,
+  AGENT_ARTERIAL,
+  AGENT_HIGHWAY,
+  AGENT_CLASSES
+};
+
+// Chances are per mille unless noted
+struct StreetPolicy {
+  static constexpr AgentClass CLASS = AGENT_STREET;
+  static constexpr uint8_t  ROAD = 35;        // road mark per step
+  static constexpr uint8_t  LIGHT = 45;       // extra light deposit
+  static constexpr uint8_t  LIGHT_PCT = 25;   // percent
+  static constexpr uint16_t TURN = 40;        // each way
+  static constexpr uint16_t BRANCH = 30;
+  static constexpr int8_t   CURVE = 2;        // max heading drift per step
+  static constexpr AgentClass BRANCH_INTO = AGENT_STREET;
+  static constexpr uint8_t  ZONE = Zoning::ZONE_RES;   // zone seeded beside the road
+  static constexpr uint16_t ZONE_SEED = 3;
+};
+
+struct ArterialPolicy {
+  static constexpr AgentClass CLASS = AGENT_ARTERIAL;
+  static constexpr uint8_t  ROAD = 55;
+  static constexpr uint8_t  LIGHT = 45;
+  static constexpr uint8_t  LIGHT_PCT = 30;
+  static constexpr uint16_t TURN = 15;
+  static constexpr uint16_t BRANCH = 25;
+  static constexpr int8_t   CURVE = 1;
+  static constexpr AgentClass BRANCH_INTO = AGENT_STREET;
+  static constexpr uint8_t  ZONE = Zoning::ZONE_COM;
+  static constexpr uint16_t ZONE_SEED = 2;
+};
+
+// "10% of walkers deposit stronger brightness and turn less often"
+struct HighwayPolicy {
+  static constexpr AgentClass CLASS = AGENT_HIGHWAY;
+  static constexpr uint8_t  ROAD = 80;
+  static constexpr uint8_t  LIGHT = 60;
+  static constexpr uint8_t  LIGHT_PCT = 15;
+  static constexpr uint16_t TURN = 4;
+  static constexpr uint16_t BRANCH = 15;
+  static constexpr int8_t   CURVE = 1;
+  static constexpr AgentClass BRANCH_INTO = AGENT_ARTERIAL;
+  static constexpr uint8_t  ZONE = Zoning::ZONE_IND;
+  static constexpr uint16_t ZONE_SEED = 4;
+};
+
+// The agent-walker engine: roads are laid by agents wandering out of
+// downtown, with bright nodes dropped now and then.
+class CitySim : public GridEngine {
 public:
   CitySim(uint16_t w, uint16_t h)
-  : W(w), H(h) {
-    grid = (uint8_t*)malloc(W * H);
-    reset();
+  : GridEngine(w, h) {
+    mask.init(W, H);
+#if CITY_ROAD_GRAPH
+    graph.init((W + (1 << GRAPH_SHIFT) - 1) >> GRAPH_SHIFT,
+               (H + (1 << GRAPH_SHIFT) - 1) >> GRAPH_SHIFT);
+#endif
+    zones.init(W, H);
+    steer.init(W, H);
+    value.init(W, H);
   }
 
-  ~CitySim() {
-    if (grid) free(grid);
-  }
-
-  void reset() {
+  void reset(uint32_t seed) {
     if (!grid) return;
-    memset(grid, 0, W * H);
-    agentCount = 0;
+    seedRandom(seed);
+    clearGrid();
+#if CITY_ROAD_GRAPH
+    graph.clear();
+#endif
+    if (zones.valid()) zones.clear();
+    steer.clear();
+    value.clear();
+    memset(poolCount, 0, sizeof(poolCount));
 
     // seed at center
     seedX = W / 2;
     seedY = H / 2;
-    addAgent(seedX, seedY, 1, 0, 255);
-    addAgent(seedX, seedY, 0, 1, 255);
-    addAgent(seedX, seedY, -1, 0, 255);
-    addAgent(seedX, seedY, 0, -1, 255);
+    districts.addSite(seedX, seedY);
+    memset(budget, LIGHT_BUDGET, sizeof(budget));
+    generateMask();
+
+    // arterials run north/south out of downtown, and the highway pool is
+    // filled with spokes (nothing branches into highways and dead ones
+    // respawn in their own pool, so this keeps them ~10% of all agents)
+    addAgent(AGENT_ARTERIAL, seedX, seedY, 64, 255);
+    addAgent(AGENT_ARTERIAL, seedX, seedY, 192, 255);
+    for (uint8_t i = 0; i < POOL_CAP[AGENT_HIGHWAY]; i++) {
+      addAgent(AGENT_HIGHWAY, seedX, seedY, (uint8_t)(i * 256 / POOL_CAP[AGENT_HIGHWAY]), 255);
+    }
 
-    // initial “downtown”
+    // initial “downtown”, zoned commercial
     bloom(seedX, seedY, 6, 120);
+    if (zones.valid()) zones.seed(seedX, seedY, Zoning::ZONE_COM, 3);
     steps = 0;
-    nextBrightNodeStep = 400 + (esp_random() % 600);
+    nextBrightNodeStep = 400 + (rand32() % 600);
   }
 
   // One simulation tick (do multiple per frame for speed)
@@ -45,51 +134,160 @@ public:
     // Occasionally drop a bright node (“stadium/dense district”)
     if (steps >= nextBrightNodeStep) {
       placeBrightNode();
-      nextBrightNodeStep = steps + 600 + (esp_random() % 1200);
+      nextBrightNodeStep = steps + 600 + (rand32() % 1200);
+    }
+
+    // Keep a slice of the steering field current, then move the agents
+    if (steer.valid()) steer.update(grid, mask.valid() ? &mask : nullptr, STEER_CELLS);
+    if (value.valid()) value.update(grid, VALUE_CELLS);
+
+    // Update agents, one specialised loop per class
+    stepPool<StreetPolicy>();
+    stepPool<ArterialPolicy>();
+    stepPool<HighwayPolicy>();
+
+    // Very slow decay - only every 500 steps, decay by 1
+    if ((steps % 500) == 0) decay(1);
+
+    if ((steps % BUDGET_STEPS) == 0) memset(budget, LIGHT_BUDGET, sizeof(budget));
+
+    // Zoning grows one generation every ZONE_STEPS, never into water, and
+    // is handed to the renderer as land use
+    if ((steps % ZONE_STEPS) == 0 && zones.valid()) {
+      zones.step(mask.valid() ? &mask : nullptr);
+      if (land.valid()) {
+        land.pack(zones.plane(Zoning::ZONE_RES), zones.plane(Zoning::ZONE_COM),
+                  zones.plane(Zoning::ZONE_IND), dirty);
+      }
+    }
+
+    // Safety net: ensure minimum active agents to keep roads drawing
+    uint8_t active[AGENT_CLASSES] = {};
+    uint8_t activeCount = 0;
+    for (uint8_t c = 0; c < AGENT_CLASSES; c++) {
+      const Agent *pool = agents + POOL_BASE[c];
+      for (uint8_t i = 0; i < poolCount[c]; i++) {
+        if (pool[i].life > 0) active[c]++;
+      }
+      activeCount += active[c];
     }
 
-    // Update agents
-    for (uint8_t i = 0; i < agentCount; i++) {
-      Agent &a = agents[i];
+    // If too few active, force respawn some dead agents, each class up to
+    // its pool's share of REVIVE_TO (so highways stay ~10% of the walkers)
+    if (activeCount < REVIVE_BELOW) {
+      for (uint8_t c = 0; c < AGENT_CLASSES; c++) {
+        uint8_t want = (REVIVE_TO * POOL_CAP[c] + MAX_AGENTS / 2) / MAX_AGENTS;
+        Agent *pool = agents + POOL_BASE[c];
+        for (uint8_t i = 0; i < poolCount[c] && active[c] < want; i++) {
+          if (pool[i].life == 0) {
+            respawnAgent(pool[i]);
+            active[c]++;
+          }
+        }
+      }
+    }
+  }
+
+  // Water/park cells agents won't enter (1 bit per cell)
+  const BitPlane &waterMask() const { return mask; }
+  uint32_t maskCoverage() const { return mask.valid() ? mask.count() : 0; }
+
+  // Road network (nodes/edges) over the 8x8-pixel blocks agents have walked
+#if CITY_ROAD_GRAPH
+  const RoadGraph &roadGraph() const { return graph; }
+  RoadGraph &roadGraph() { return graph; }
+#endif
+
+  // Housing/commerce/industry layer grown along the roads
+  const Zoning &zoning() const { return zones; }
+
+private:
+  template <class P>
+  void stepPool() {
+    Agent *pool = agents + POOL_BASE[P::CLASS];
+    const bool useMask = mask.valid();
+#if CITY_ROAD_GRAPH
+    const bool useGraph = graph.valid();
+#endif
+    const bool useZones = zones.valid();
+    const bool useSteer = steer.valid();
+    const bool useValue = value.valid();
+    const int32_t maxX = (int32_t)(W - 2) << 16;
+    const int32_t maxY = (int32_t)(H - 2) << 16;
+
+    for (uint8_t i = 0; i < poolCount[P::CLASS]; i++) {
+      Agent &a = pool[i];
       if (a.life == 0) continue;
 
-      // “road” mark
-      addIntensity(a.x, a.y, 35);
-
-      // chance to add lights along roads
-      if ((esp_random() % 100) < 25) addIntensity(a.x, a.y, 45);
-
-      // random turn
-      uint32_t r = esp_random() % 1000;
-      if (r < 40) { // left turn
-        int8_t ndx = -a.dy;
-        int8_t ndy = a.dx;
-        a.dx = ndx; a.dy = ndy;
-      } else if (r < 80) { // right turn
-        int8_t ndx = a.dy;
-        int8_t ndy = -a.dx;
-        a.dx = ndx; a.dy = ndy;
+      // “road” mark, spread over the 2x2 cells under the agent
+      deposit(a.x, a.y, P::ROAD);
+      int16_t cx = (a.x + 0x8000) >> 16, cy = (a.y + 0x8000) >> 16;
+#if CITY_ROAD_GRAPH
+      if (useGraph) graph.addCell(cx >> GRAPH_SHIFT, cy >> GRAPH_SHIFT);
+#endif
+      if (useZones) {
+        zones.markRoad(cx, cy);
+        if ((rand32() % 1000) < P::ZONE_SEED) zones.seed(cx, cy, P::ZONE, 1);
       }
 
-      // branch sometimes (increased rate for more road network)
-      if (agentCount < MAX_AGENTS && (esp_random() % 1000) < 30) {
+      // land value scales the light and branch chances (Q8)
+      uint16_t gain = useValue ? LandValue::gain(value.at(cx, cy)) : 256;
+
+      // chance to add lights along roads, brighter in commercial zones
+      if ((rand32() % 100) < (((uint32_t)P::LIGHT_PCT * gain) >> 8) && spendLight(cx, cy)) {
+        uint8_t z = useZones ? zones.at(cx, cy) : (uint8_t)Zoning::ZONE_NONE;
+        deposit(a.x, a.y, (uint8_t)(P::LIGHT * ZONE_LIGHT_PCT[z] / 100));
+      }
+
+      // hard turn now and then, otherwise keep following the current arc.
+      // Where the steering field has a direction, turns and new arcs go
+      // its way, and an agent already heading that way doesn't turn.
+      uint8_t want = useSteer ? steer.dirAt(cx, cy) : SteerField::NONE;
+      int8_t off = (int8_t)(uint8_t)(want - a.heading);
+      uint32_t r = rand32() % 1000;
+      if (r < 2 * P::TURN) {
+        if (want == SteerField::NONE) a.heading += (r < P::TURN) ? -64 : 64;
+        else if (off < -32 || off > 32) a.heading += (off < 0) ? -64 : 64;
+      } else if (r < 2 * P::TURN + CURVE_CHANGE) {
+        a.curve = randomCurve(P::CURVE);
+        if (want != SteerField::NONE && (off < 0) != (a.curve < 0)) a.curve = -a.curve;
+      }
+      a.heading += a.curve;
+
+      // branch sometimes, more often where land is worth more
+      if (poolCount[P::BRANCH_INTO] < POOL_CAP[P::BRANCH_INTO] &&
+          (rand32() % 1000) < (((uint32_t)P::BRANCH * gain) >> 8)) {
         // spawn a new agent turned left/right
-        int8_t ndx = (esp_random() & 1) ? -a.dy : a.dy;
-        int8_t ndy = (ndx == -a.dy) ? a.dx : -a.dx;
-        addAgent(a.x, a.y, ndx, ndy, 140 + (esp_random() % 100));
+        uint8_t h = a.heading + ((rand32() & 1) ? 64 : -64);
+        addAgentFixed(P::BRANCH_INTO, a.x, a.y, h, 140 + (rand32() % 100));
       }
 
-      // move
-      a.x += a.dx;
-      a.y += a.dy;
+      // move, unless that would walk into water/park: turn instead
+      int32_t nx = a.x + (int32_t)icos8(a.heading) * 256;
+      int32_t ny = a.y + (int32_t)isin8(a.heading) * 256;
+      int16_t ncx = (nx + 0x8000) >> 16, ncy = (ny + 0x8000) >> 16;
+      if (useMask && mask.test(ncx, ncy)) {
+        a.heading += (rand32() & 1) ? 64 : -64;
+      } else {
+        a.x = nx;
+        a.y = ny;
+#if CITY_ROAD_GRAPH
+        // keep the road graph 4-connected across diagonal block steps
+        int16_t bx = cx >> GRAPH_SHIFT, by = cy >> GRAPH_SHIFT;
+        int16_t nbx = ncx >> GRAPH_SHIFT, nby = ncy >> GRAPH_SHIFT;
+        if (useGraph && bx != nbx && by != nby &&
+            nbx >= 0 && nbx < (int16_t)graph.width()) {
+          graph.addCell(nbx, by);
+        }
+#endif
+      }
 
       // bounce off edges
-      if (a.x < 1 || a.x >= (int16_t)W-1 || a.y < 1 || a.y >= (int16_t)H-1) {
-        a.x = constrain(a.x, 1, (int16_t)W-2);
-        a.y = constrain(a.y, 1, (int16_t)H-2);
+      if (a.x < (1 << 16) || a.x > maxX || a.y < (1 << 16) || a.y > maxY) {
+        a.x = constrain(a.x, (int32_t)1 << 16, maxX);
+        a.y = constrain(a.y, (int32_t)1 << 16, maxY);
         // turn around-ish
-        a.dx = -a.dx;
-        a.dy = -a.dy;
+        a.heading += 128;
         a.life = (a.life > 30) ? (a.life - 30) : 0;
       } else {
         // life decay
@@ -97,42 +295,52 @@ public:
       }
 
       // If dead, respawn frequently to keep growth going
-      if (a.life == 0 && (esp_random() % 100) < 15) {
+      if (a.life == 0 && (rand32() % 100) < 15) {
         respawnAgent(a);
       }
     }
+  }
 
-    // Very slow decay - only every 500 steps, decay by 1
-    if ((steps % 500) == 0) decay(1);
-
-    // Safety net: ensure minimum active agents to keep roads drawing
-    uint8_t activeCount = 0;
-    for (uint8_t i = 0; i < agentCount; i++) {
-      if (agents[i].life > 0) activeCount++;
-    }
+  // Each district may only add so many lights per BUDGET_STEPS, so a busy
+  // district can't saturate while the others stay dark
+  bool spendLight(int16_t x, int16_t y) {
+    uint8_t d = districts.atPixel(x, y);
+    if (d == DistrictMap::NONE) return true;
+    if (!budget[d]) return false;
+    budget[d]--;
+    return true;
+  }
 
-    // If too few active, force respawn some dead agents
-    if (activeCount < 8) {
-      for (uint8_t i = 0; i < agentCount && activeCount < 12; i++) {
-        if (agents[i].life == 0) {
-          respawnAgent(agents[i]);
-          activeCount++;
-        }
-      }
-    }
+  int8_t randomCurve(int8_t maxCurve) {
+    return (int8_t)((int32_t)(rand32() % (2 * maxCurve + 1)) - maxCurve);
   }
 
-  uint8_t get(uint16_t x, uint16_t y) const {
-    return grid[y * W + x];
+  // Bilinear deposit at a 16.16 position: weights are the 8-bit fractions,
+  // so an agent exactly on a cell puts everything in that cell. Taps on
+  // water/park cells are dropped, so roads don't bleed onto the shore.
+  void deposit(int32_t x, int32_t y, uint8_t amt) {
+    int16_t ix = x >> 16, iy = y >> 16;
+    uint16_t fx = (x >> 8) & 0xFF, fy = (y >> 8) & 0xFF;
+    uint16_t w11 = (fx * fy) >> 8;
+    uint16_t w10 = fx - w11;              // (ix+1, iy)
+    uint16_t w01 = fy - w11;              // (ix, iy+1)
+    uint16_t w00 = 256 - fx - fy + w11;
+    uint8_t a00 = (amt * w00) >> 8, a10 = (amt * w10) >> 8;
+    uint8_t a01 = (amt * w01) >> 8, a11 = (amt * w11) >> 8;
+    const bool useMask = mask.valid();
+    if (a00 && !(useMask && mask.test(ix, iy))) addIntensity(ix, iy, a00);
+    if (a10 && !(useMask && mask.test(ix + 1, iy))) addIntensity(ix + 1, iy, a10);
+    if (a01 && !(useMask && mask.test(ix, iy + 1))) addIntensity(ix, iy + 1, a01);
+    if (a11 && !(useMask && mask.test(ix + 1, iy + 1))) addIntensity(ix + 1, iy + 1, a11);
   }
 
-  uint16_t width()  const { return W; }
-  uint16_t height() const { return H; }
+  void addAgentFixed(uint8_t cls, int32_t x, int32_t y, uint8_t heading, uint8_t life) {
+    if (poolCount[cls] >= POOL_CAP[cls]) return;
+    agents[POOL_BASE[cls] + poolCount[cls]++] = Agent{x, y, heading, randomCurve(1), life};
+  }
 
-private:
-  void addAgent(int16_t x, int16_t y, int8_t dx, int8_t dy, uint8_t life) {
-    if (agentCount >= MAX_AGENTS) return;
-    agents[agentCount++] = Agent{x, y, dx, dy, life};
+  void addAgent(uint8_t cls, int16_t x, int16_t y, uint8_t heading, uint8_t life) {
+    addAgentFixed(cls, (int32_t)x << 16, (int32_t)y << 16, heading, life);
   }
 
   void respawnAgent(Agent &a) {
@@ -142,9 +350,10 @@ private:
 
     // Sample random spots, pick one with some light
     for (uint8_t tries = 0; tries < 15; tries++) {
-      int16_t rx = 2 + (esp_random() % (W - 4));
-      int16_t ry = 2 + (esp_random() % (H - 4));
+      int16_t rx = 2 + (rand32() % (W - 4));
+      int16_t ry = 2 + (rand32() % (H - 4));
       uint8_t v = get(rx, ry);
+      if (mask.valid() && mask.test(rx, ry)) continue;
       if (v > bestVal && v < 200) {  // Has light but not saturated
         bestVal = v;
         bestX = rx;
@@ -152,80 +361,132 @@ private:
       }
     }
 
-    static const int8_t dirs[4][2] = {{1,0},{-1,0},{0,1},{0,-1}};
-    uint8_t d = esp_random() % 4;
-    a.x = bestX;
-    a.y = bestY;
-    a.dx = dirs[d][0];
-    a.dy = dirs[d][1];
-    a.life = 200 + (esp_random() % 55);  // Longer life
+    // start axis-aligned; curve bends it from there
+    a.x = (int32_t)bestX << 16;
+    a.y = (int32_t)bestY << 16;
+    a.heading = (rand32() % 4) * 64;
+    a.curve = randomCurve(1);
+    a.life = 200 + (rand32() % 55);  // Longer life
   }
 
-  void addIntensity(int16_t x, int16_t y, uint8_t amt) {
-    uint16_t idx = (uint16_t)y * W + (uint16_t)x;
-    uint16_t v = grid[idx] + amt;
-    grid[idx] = (v > 255) ? 255 : (uint8_t)v;
+  // Blooms never light up water/parks
+  void bloom(int16_t cx, int16_t cy, uint8_t radius, uint8_t strength) {
+    GridEngine::bloom(cx, cy, radius, strength, mask.valid() ? &mask : nullptr);
   }
 
-  void decay(uint8_t amt) {
-    for (uint32_t i = 0; i < (uint32_t)W * H; i++) {
-      uint8_t v = grid[i];
-      grid[i] = (v > amt) ? (v - amt) : 0;
+  // A few big dark blobs (lakes/parks) made of overlapping discs, kept
+  // away from the downtown seed. Their outline is drawn as a faint shore.
+  void generateMask() {
+    if (!mask.valid()) return;
+    mask.clearAll();
+
+    const uint32_t maxCells = (uint32_t)W * H * MASK_MAX_PCT / 100;
+    uint8_t blobs = 2 + (rand32() % 3);
+    for (uint8_t b = 0; b < blobs; b++) {
+      int16_t cx = 10 + (rand32() % (W - 20));
+      int16_t cy = 10 + (rand32() % (H - 20));
+      uint8_t lobes = 3 + (rand32() % 4);
+      for (uint8_t l = 0; l < lobes; l++) {
+        int16_t lx = cx + (int16_t)((int32_t)(rand32() % 25) - 12);
+        int16_t ly = cy + (int16_t)((int32_t)(rand32() % 17) - 8);
+        int16_t r  = 5 + (rand32() % 9);
+        int32_t ddx = lx - seedX, ddy = ly - seedY;
+        int32_t keep = r + MASK_SEED_CLEARANCE;
+        if (ddx*ddx + ddy*ddy < keep*keep) continue;
+        fillMaskDisc(lx, ly, r);
+      }
+      if (mask.count() > maxCells) break;
     }
+
+    BitPlane shore;
+    if (!shore.init(W, H)) return;
+    mask.edges(shore);
+    shore.forEachSet([&](uint16_t x, uint16_t y) {
+      setIntensity(x, y, SHORE_INTENSITY);
+    });
   }
 
-  void bloom(int16_t cx, int16_t cy, uint8_t radius, uint8_t strength) {
-    for (int16_t y = -radius; y <= radius; y++) {
-      for (int16_t x = -radius; x <= radius; x++) {
-        int16_t px = cx + x;
-        int16_t py = cy + y;
-        if (px < 1 || px >= (int16_t)W-1 || py < 1 || py >= (int16_t)H-1) continue;
-        int16_t d2 = x*x + y*y;
-        if (d2 > radius*radius) continue;
-
-        // stronger in center
-        uint8_t add = strength - (uint8_t)(min<int16_t>(strength, d2 * 3));
-        addIntensity(px, py, add);
-      }
+  void fillMaskDisc(int16_t cx, int16_t cy, int16_t r) {
+    for (int16_t dy = -r; dy <= r; dy++) {
+      int16_t y = cy + dy;
+      if (y < 0 || y >= (int16_t)H) continue;
+      int16_t rem = r*r - dy*dy;
+      int16_t half = 0;
+      while ((half + 1) * (half + 1) <= rem) half++;
+      mask.setSpan(y, cx - half, cx + half);
     }
   }
 
   void placeBrightNode() {
-    // pick a spot biased toward existing activity
+    // pick the most valuable land of a few samples, skipping the
+    // saturated core so nodes found new centres around it
     int16_t bestX = seedX, bestY = seedY;
     uint8_t best = 0;
 
     for (uint8_t tries = 0; tries < 20; tries++) {
-      int16_t x = 2 + (esp_random() % (W - 4));
-      int16_t y = 2 + (esp_random() % (H - 4));
-      uint8_t v = get(x, y);
-      if (v > best) { best = v; bestX = x; bestY = y; }
+      int16_t x = 2 + (rand32() % (W - 4));
+      int16_t y = 2 + (rand32() % (H - 4));
+      uint8_t v = value.valid() ? value.at(x, y) : get(x, y);
+      if (v > best && v < 255) { best = v; bestX = x; bestY = y; }
     }
 
-    // stadium core + halo
+    // stadium core + halo, and a district of its own
+    districts.addSite(bestX, bestY);
+    if (zones.valid()) zones.seed(bestX, bestY, Zoning::ZONE_COM, 2);
     bloom(bestX, bestY, 10, 220);
     bloom(bestX, bestY, 18, 90);
 
     // spawn extra agents around it for “district growth”
-    for (uint8_t i = 0; i < 5 && agentCount < MAX_AGENTS; i++) {
-      int16_t rx = bestX + (int16_t)((int32_t)(esp_random() % 21) - 10);
-      int16_t ry = bestY + (int16_t)((int32_t)(esp_random() % 21) - 10);
+    for (uint8_t i = 0; i < 5 && poolCount[AGENT_STREET] < POOL_CAP[AGENT_STREET]; i++) {
+      int16_t rx = bestX + (int16_t)((int32_t)(rand32() % 21) - 10);
+      int16_t ry = bestY + (int16_t)((int32_t)(rand32() % 21) - 10);
       rx = constrain(rx, 2, (int16_t)W-3);
       ry = constrain(ry, 2, (int16_t)H-3);
+      if (mask.valid() && mask.test(rx, ry)) continue;
 
-      static const int8_t dirs[4][2] = {{1,0},{-1,0},{0,1},{0,-1}};
-      uint8_t d = esp_random() % 4;
-      addAgent(rx, ry, dirs[d][0], dirs[d][1], 200 + (esp_random() % 55));
+      addAgent(AGENT_STREET, rx, ry, (rand32() % 4) * 64, 200 + (rand32() % 55));
     }
   }
 
-private:
-  const uint16_t W, H;
-  uint8_t *grid = nullptr;
+  // Water/parks
+  static constexpr uint8_t MASK_MAX_PCT = 12;         // stop adding blobs past this
+  static constexpr int16_t MASK_SEED_CLEARANCE = 20;  // keep downtown dry
+  static constexpr uint8_t SHORE_INTENSITY = 14;
+  BitPlane mask;
+
+#if CITY_ROAD_GRAPH
+  static constexpr uint8_t GRAPH_SHIFT = 3;   // graph cell = 8x8 pixels
+  RoadGraph graph;
+#endif
 
+  // Zoning: light deposit scale per zone (none, housing, commerce, industry)
+  static constexpr uint8_t ZONE_STEPS = 20;
+  static constexpr uint8_t ZONE_LIGHT_PCT[Zoning::ZONES] = {100, 100, 150, 60};
+  Zoning zones;
+
+  // Steering field cells refreshed per step (a full sweep is ~128 steps)
+  static constexpr uint8_t STEER_CELLS = 4;
+  SteerField steer;
+
+  // Land value cells refreshed per step (a full sweep is ~128 steps)
+  static constexpr uint8_t VALUE_CELLS = 4;
+  LandValue value;
+
+  // One contiguous slice of agents[] per class: streets, arterials, highways
   static constexpr uint8_t MAX_AGENTS = 60;
+  static constexpr uint8_t POOL_CAP[AGENT_CLASSES]  = {46, 8, 6};
+  static constexpr uint8_t POOL_BASE[AGENT_CLASSES] = {0, 46, 54};
+  static constexpr uint16_t CURVE_CHANGE = 15;   // per mille: pick a new arc
+  static constexpr uint8_t REVIVE_BELOW = 8;     // live agents
+  static constexpr uint8_t REVIVE_TO = 12;
+  static_assert(POOL_BASE[AGENT_HIGHWAY] + POOL_CAP[AGENT_HIGHWAY] == MAX_AGENTS,
+                "agent pools must tile agents[]");
   Agent agents[MAX_AGENTS];
-  uint8_t agentCount = 0;
+  uint8_t poolCount[AGENT_CLASSES] = {};
+
+  static constexpr uint8_t BUDGET_STEPS = 50;
+  static constexpr uint8_t LIGHT_BUDGET = 40;   // light deposits per district
+  uint8_t budget[DistrictMap::MAX_SITES];
 
   int16_t seedX = 0, seedY = 0;
   uint32_t steps = 0;
@@ -0,0 +1,110 @@
+#pragma once
+#include <Arduino.h>
+#include "Palette.h"
+
+// Time-of-day controller. The grid never changes: dusk -> night -> late
+// night is expressed purely as a per-intensity shade applied when the
+// palette bank is rebuilt. Lights in the warm band switch on and off one
+// intensity at a time (each intensity gets a pseudo-random rank), so on
+// screen individual buildings light up rather than the whole city fading.
+//
+// The screen is split into coarse 8x8-pixel cells, each mapped to one of
+// LUT_GROUPS lookup groups; each group runs the cycle with its own phase
+// offset so districts don't switch in lockstep.
+class DayNightCycle {
+public:
+  static constexpr uint8_t CELL_SHIFT = 3;
+  static constexpr uint8_t MAX_CELLS  = 32;   // per axis
+
+  void init(uint16_t w, uint16_t h) {
+    cols = (w + (1 << CELL_SHIFT) - 1) >> CELL_SHIFT;
+    rows = (h + (1 << CELL_SHIFT) - 1) >> CELL_SHIFT;
+    memset(groups, 0, sizeof(groups));
+  }
+
+  // Blocky random districts (4x4 cells each) until the sim provides real ones
+  void randomizeGroups() {
+    for (uint8_t by = 0; by < rows; by += 4) {
+      for (uint8_t bx = 0; bx < cols; bx += 4) {
+        uint8_t g = esp_random() % LUT_GROUPS;
+        for (uint8_t cy = by; cy < by + 4 && cy < rows; cy++)
+          for (uint8_t cx = bx; cx < bx + 4 && cx < cols; cx++)
+            groups[cy][cx] = g;
+      }
+    }
+  }
+
+  void setGroup(uint8_t cx, uint8_t cy, uint8_t g) { groups[cy][cx] = g % LUT_GROUPS; }
+  const uint8_t *groupRow(uint8_t cy) const { return groups[cy]; }
+  uint8_t cellCols() const { return cols; }
+  uint8_t cellRows() const { return rows; }
+
+  void setEnabled(bool on) { enabled = on; }
+  bool isEnabled() const { return enabled; }
+  void setCycleMs(uint32_t ms) { cycleMs = ms ? ms : 1; }
+
+  // Work out each group's lights-on level and ambient scale for this moment.
+  // Call before PaletteBank::build().
+  void prepare(uint32_t nowMs) {
+    for (uint8_t g = 0; g < LUT_GROUPS; g++) {
+      if (!enabled) { lightsOn[g] = 256 + SOFT; ambient[g] = 256; continue; }
+      uint32_t t = nowMs + g * (cycleMs / GROUP_SPREAD);
+      uint16_t pos = (uint16_t)(((uint64_t)(t % cycleMs) << 16) / cycleMs);
+      sample(pos, lightsOn[g], ambient[g]);
+    }
+  }
+
+  // Q8 shade for intensity v in group g (after prepare())
+  uint16_t shade(uint8_t g, uint8_t v) const {
+    if (v < PaletteAnimator::WARM_LO) return ambient[g];
+    // Light v is fully on once lightsOn passes its rank, ramping over SOFT
+    uint8_t rank = (uint8_t)(v * 151);
+    int16_t over = lightsOn[g] - rank;
+    if (over <= 0) return LIGHT_OFF;
+    if (over >= SOFT) return 256;
+    return LIGHT_OFF + (uint16_t)((256 - LIGHT_OFF) * over / SOFT);
+  }
+
+  // 0 = dusk, 1 = night, 2 = late night (for group 0)
+  uint8_t phase(uint32_t nowMs) const {
+    uint16_t pos = (uint16_t)(((uint64_t)(nowMs % cycleMs) << 16) / cycleMs);
+    if (pos < KEYS[1].pos) return 0;
+    if (pos < KEYS[2].pos) return 1;
+    return 2;
+  }
+
+private:
+  struct Key { uint16_t pos; int16_t lights; uint16_t ambient; };
+
+  // Closed loop over one cycle (pos is 0..65535): dusk, night, late night
+  static constexpr Key KEYS[] = {
+    {0,     100, 240},   // dusk: sky just dark, few lights
+    {13107, 288, 256},   // 20%: night, everything on
+    {36044, 288, 256},   // 55%: late night begins
+    {55705, 110, 215},   // 85%: most lights off, roads dim
+  };
+  static constexpr uint8_t KEY_COUNT = sizeof(KEYS) / sizeof(KEYS[0]);
+
+  static void sample(uint16_t pos, int16_t &lights, uint16_t &amb) {
+    uint8_t i = KEY_COUNT - 1;
+    while (i > 0 && pos < KEYS[i].pos) i--;
+    const Key &a = KEYS[i];
+    const Key &b = KEYS[(i + 1) % KEY_COUNT];
+    uint32_t end  = (i + 1 < KEY_COUNT) ? b.pos : 65536u;
+    uint32_t span = end - a.pos;
+    uint32_t t    = pos - a.pos;
+    lights = a.lights + (int16_t)(((int32_t)(b.lights - a.lights) * (int32_t)t) / (int32_t)span);
+    amb    = a.ambient + (int16_t)(((int32_t)(b.ambient - a.ambient) * (int32_t)t) / (int32_t)span);
+  }
+
+  static constexpr int16_t  SOFT = 32;         // ranks over which a light fades in
+  static constexpr uint16_t LIGHT_OFF = 90;    // Q8 level of a light that's off
+  static constexpr uint8_t  GROUP_SPREAD = 16; // group phase step = cycle / 16
+
+  bool enabled = true;
+  uint32_t cycleMs = 10UL * 60 * 1000;
+  uint8_t cols = 0, rows = 0;
+  uint8_t groups[MAX_CELLS][MAX_CELLS] = {};
+  int16_t  lightsOn[LUT_GROUPS] = {};
+  uint16_t ambient[LUT_GROUPS] = {};
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include <Arduino.h>
+
+// Coarse change tracking: one bit per 16x16 tile, one 16-bit mask per tile
+// row. Marking a pixel is a shift and an OR, so it can sit in hot paths.
+// Supports grids up to 256x256 (240x135 -> 15x9 tiles).
+class DirtyTiles {
+public:
+  static constexpr uint8_t  SHIFT = 4;
+  static constexpr uint8_t  TILE  = 1 << SHIFT;
+  static constexpr uint8_t  MAX_ROWS = 16;
+
+  void init(uint16_t w, uint16_t h) {
+    W = w; H = h;
+    cols = (w + TILE - 1) >> SHIFT;
+    rowCount = (h + TILE - 1) >> SHIFT;
+    clear();
+  }
+
+  inline void mark(uint16_t x, uint16_t y) {
+    rows[y >> SHIFT] |= (uint16_t)(1u << (x >> SHIFT));
+  }
+
+  // Inclusive pixel rect, clipped to the grid
+  void markRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= (int16_t)W) x1 = W - 1;
+    if (y1 >= (int16_t)H) y1 = H - 1;
+    if (x0 > x1 || y0 > y1) return;
+    uint8_t tx0 = x0 >> SHIFT, tx1 = x1 >> SHIFT;
+    uint16_t m = (uint16_t)(((1u << (tx1 + 1)) - 1) & ~((1u << tx0) - 1));
+    for (uint8_t ty = y0 >> SHIFT; ty <= (y1 >> SHIFT); ty++) rows[ty] |= m;
+  }
+
+  void markAll() {
+    uint16_t m = (uint16_t)((1u << cols) - 1);
+    for (uint8_t ty = 0; ty < rowCount; ty++) rows[ty] = m;
+  }
+
+  void clear() {
+    memset(rows, 0, sizeof(rows));
+  }
+
+  void merge(const DirtyTiles &o) {
+    for (uint8_t ty = 0; ty < rowCount; ty++) rows[ty] |= o.rows[ty];
+  }
+
+  // Grow every dirty tile by one tile in each direction
+  void dilate() {
+    uint16_t full = (uint16_t)((1u << cols) - 1);
+    uint16_t prev = 0;
+    for (uint8_t ty = 0; ty < rowCount; ty++) {
+      uint16_t cur  = rows[ty];
+      uint16_t next = (ty + 1 < rowCount) ? rows[ty + 1] : 0;
+      uint16_t v = prev | cur | next;
+      prev = cur;
+      rows[ty] = (uint16_t)((v | (v << 1) | (v >> 1)) & full);
+    }
+  }
+
+  // Tiles whose pixels land in other tiles once moved by (dx, dy) px
+  // (|dx|, |dy| < TILE) also mark the tiles they move into
+  void shift(int8_t dx, int8_t dy) {
+    uint16_t full = (uint16_t)((1u << cols) - 1);
+    if (dx) {
+      for (uint8_t ty = 0; ty < rowCount; ty++) {
+        uint16_t m = rows[ty];
+        rows[ty] = (uint16_t)((m | (dx > 0 ? m << 1 : m >> 1)) & full);
+      }
+    }
+    if (dy > 0) {
+      for (uint8_t ty = rowCount - 1; ty > 0; ty--) rows[ty] |= rows[ty - 1];
+    } else if (dy < 0) {
+      for (uint8_t ty = 0; ty + 1 < rowCount; ty++) rows[ty] |= rows[ty + 1];
+    }
+  }
+
+  inline bool test(uint16_t x, uint16_t y) const {
+    return (rows[y >> SHIFT] >> (x >> SHIFT)) & 1;
+  }
+
+  // True if any tile overlapping the inclusive pixel rect is dirty
+  bool intersects(int16_t x0, int16_t y0, int16_t x1, int16_t y1) const {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= (int16_t)W) x1 = W - 1;
+    if (y1 >= (int16_t)H) y1 = H - 1;
+    if (x0 > x1 || y0 > y1) return false;
+    uint8_t tx0 = x0 >> SHIFT, tx1 = x1 >> SHIFT;
+    uint16_t m = (uint16_t)(((1u << (tx1 + 1)) - 1) & ~((1u << tx0) - 1));
+    for (uint8_t ty = y0 >> SHIFT; ty <= (y1 >> SHIFT); ty++) if (rows[ty] & m) return true;
+    return false;
+  }
+
+  bool any() const {
+    for (uint8_t ty = 0; ty < rowCount; ty++) if (rows[ty]) return true;
+    return false;
+  }
+
+  uint16_t count() const {
+    uint16_t n = 0;
+    for (uint8_t ty = 0; ty < rowCount; ty++) n += __builtin_popcount(rows[ty]);
+    return n;
+  }
+
+  // Calls fn(tx0, tx1) for each run of consecutive dirty tiles in a row mask
+  template <class Fn>
+  static void forEachRun(uint16_t m, Fn fn) {
+    uint8_t tx = 0;
+    while (m) {
+      while (!(m & 1)) { m >>= 1; tx++; }
+      uint8_t start = tx;
+      while (m & 1) { m >>= 1; tx++; }
+      fn(start, (uint8_t)(tx - 1));
+    }
+  }
+
+  uint16_t row(uint8_t ty) const { return rows[ty]; }
+  uint8_t  tileCols() const { return cols; }
+  uint8_t  tileRows() const { return rowCount; }
+
+private:
+  uint16_t W = 0, H = 0;
+  uint8_t  cols = 0, rowCount = 0;
+  uint16_t rows[MAX_ROWS] = {};
+};
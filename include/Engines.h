@@ -0,0 +1,151 @@
+#pragma once
+#include <Arduino.h>
+#include <new>
+#include <type_traits>
+#include "GridEngine.h"
+#include "CitySim.h"
+#include "ReactionDiffusion.h"
+#include "Aggregation.h"
+#include "TensorRoads.h"
+
+// Every city generator, in one list. Columns: id, class, display name, and
+// the grid hash after ENGINE_BENCH_STEPS steps from ENGINE_BENCH_SEED
+// (0 = not recorded yet; the bench then just prints it). Adding a line
+// here is all it takes for an engine to show up in selection, the bench
+// and the golden check (on device with 'b', on the host in
+// test/host/test_engine_golden.cpp).
+#define CITY_ENGINES(X) \
+  X(WALKERS, CitySim, "walkers", 0xF4736350u) \
+  X(REACTION, ReactionDiffusion, "reaction", 0xB3BFC7EDu) \
+  X(DLA, Aggregation, "dla", 0xCDF8D857u) \
+  X(TENSOR, TensorRoads, "tensor", 0xBAEFA0A5u)
+
+enum EngineId : uint8_t {
+#define X(id, cls, name, golden) ENGINE_##id,
+  CITY_ENGINES(X)
+#undef X
+  ENGINE_COUNT
+};
+
+// Build-time default, e.g. -D CITY_ENGINE=ENGINE_WALKERS
+#ifndef CITY_ENGINE
+#define CITY_ENGINE ENGINE_WALKERS
+#endif
+
+static const char *const ENGINE_NAMES[ENGINE_COUNT] = {
+#define X(id, cls, name, golden) name,
+  CITY_ENGINES(X)
+#undef X
+};
+
+static constexpr uint32_t ENGINE_GOLDEN[ENGINE_COUNT] = {
+#define X(id, cls, name, golden) golden,
+  CITY_ENGINES(X)
+#undef X
+};
+
+// Fixed run the bench times and hashes for every engine
+static constexpr uint32_t ENGINE_BENCH_SEED  = 0xC1714u;
+static constexpr uint16_t ENGINE_BENCH_STEPS = 3000;
+
+namespace engine_detail {
+// Largest size/alignment over GridEngine and every listed class
+template <class... T> constexpr size_t largestSize() {
+  size_t m = 0;
+  ((m = sizeof(T) > m ? sizeof(T) : m), ...);
+  return m;
+}
+template <class... T> constexpr size_t largestAlign() {
+  size_t m = 0;
+  ((m = alignof(T) > m ? alignof(T) : m), ...);
+  return m;
+}
+}  // namespace engine_detail
+
+// Holds the one live engine, constructed in place in storage sized for the
+// largest. The switch on the engine id runs once per call, not per step or
+// per cell: stepN() loops on the concrete type, so step() inlines and there
+// are no virtual calls anywhere. The frame loop talks to grid(), which is
+// the shared GridEngine base.
+class EngineHost {
+public:
+  EngineHost() = default;
+  EngineHost(const EngineHost &) = delete;
+  EngineHost &operator=(const EngineHost &) = delete;
+  ~EngineHost() { destroy(); }
+
+  // Replace the live engine (its buffers are freed first, so only one
+  // engine's worth of heap is ever in use). Leaves it reset to seed.
+  bool select(uint8_t engine, uint16_t w, uint16_t h, uint32_t seed) {
+    destroy();
+    id = engine % ENGINE_COUNT;
+    switch (id) {
+#define X(eid, cls, name, golden) \
+      case ENGINE_##eid: live = new (storage) cls(w, h); break;
+      CITY_ENGINES(X)
+#undef X
+      default: break;
+    }
+    if (!live) return false;
+    live->setChangeList(changes);
+    ok = false;
+    dispatch([&](auto &e) { ok = e.valid(); });
+    if (ok) reset(seed);
+    return ok;
+  }
+
+  void reset(uint32_t seed) {
+    dispatch([&](auto &e) { e.reset(seed); });
+  }
+
+  void stepN(uint16_t n) {
+    dispatch([&](auto &e) {
+      for (uint16_t i = 0; i < n; i++) e.step();
+    });
+  }
+
+  // Calls fn(engine) with the concrete engine type
+  template <class Fn>
+  void dispatch(Fn fn) {
+    if (!live) return;
+    switch (id) {
+#define X(eid, cls, name, golden) \
+      case ENGINE_##eid: fn(*static_cast<cls*>(live)); break;
+      CITY_ENGINES(X)
+#undef X
+      default: break;
+    }
+  }
+
+  // Kept across select() so a new engine reports to the same consumer
+  void setChangeList(ChangeList *c) {
+    changes = c;
+    if (live) live->setChangeList(c);
+  }
+
+  bool ready() const { return live && ok; }
+  uint8_t engine() const { return id; }
+  const char *name() const { return ENGINE_NAMES[id]; }
+  GridEngine &grid() { return *live; }
+  const GridEngine &grid() const { return *live; }
+
+private:
+#define X(eid, cls, name, golden) , cls
+  static constexpr size_t STORAGE_SIZE  = engine_detail::largestSize<GridEngine CITY_ENGINES(X)>();
+  static constexpr size_t STORAGE_ALIGN = engine_detail::largestAlign<GridEngine CITY_ENGINES(X)>();
+#undef X
+
+  void destroy() {
+    dispatch([](auto &e) {
+      using T = std::remove_reference_t<decltype(e)>;
+      e.~T();
+    });
+    live = nullptr;
+  }
+
+  alignas(STORAGE_ALIGN) uint8_t storage[STORAGE_SIZE];
+  GridEngine *live = nullptr;
+  uint8_t id = 0;
+  bool ok = false;
+  ChangeList *changes = nullptr;
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+#include "ChangeList.h"
+#include "DirtyTiles.h"
+
+// Displayed-intensity buffer that eases toward the sim grid instead of
+// jumping. The sim reports every cell it changes into pending(); each frame
+// only those cells move a fraction of the way to their target and drop off
+// the list once they arrive, so the work is proportional to what changed
+// recently, never a full-grid pass. Whole-grid events (reset, decay) come
+// through as an overflow and are snapped in one go.
+class FadeBuffer {
+public:
+  static constexpr uint8_t  RATE_SHIFT = 1;       // close half the gap per frame
+  static constexpr uint16_t MAX_PENDING = 2560;
+
+  FadeBuffer() = default;
+  FadeBuffer(const FadeBuffer &) = delete;
+  FadeBuffer &operator=(const FadeBuffer &) = delete;
+
+  ~FadeBuffer() {
+    if (shown) free(shown);
+  }
+
+  bool init(uint16_t w, uint16_t h) {
+    W = w; H = h;
+    shown = (uint8_t*)malloc((size_t)w * h);
+    if (shown) memset(shown, 0, (size_t)w * h);
+    list.init((uint32_t)w * h, MAX_PENDING);
+    list.setOverflow();
+    return valid();
+  }
+
+  bool valid() const { return shown && list.valid(); }
+
+  // Hand this to the sim so it can report changed cells
+  ChangeList &pending() { return list; }
+
+  void setEnabled(bool on) { enabled = on; }
+  bool isEnabled() const { return enabled; }
+
+  // Advance pending cells toward target, marking the tiles that changed
+  void step(const uint8_t *target, DirtyTiles &dirty) {
+    if (list.overflowed()) {
+      memcpy(shown, target, (size_t)W * H);
+      list.clear();
+      dirty.markAll();
+      return;
+    }
+
+    for (uint16_t i = 0; i < list.size(); ) {
+      uint16_t idx = list.at(i);
+      int16_t d = shown[idx], t = target[idx];
+      int16_t gap = t - d;
+      if (gap != 0) {
+        int16_t move = enabled ? (gap >> RATE_SHIFT) : gap;
+        if (move == 0) move = (gap > 0) ? 1 : -1;
+        shown[idx] = (uint8_t)(d + move);
+        dirty.mark(idx % W, idx / W);
+      }
+      if (shown[idx] == t) list.removeAt(i);
+      else i++;
+    }
+  }
+
+  const uint8_t *data() const { return shown; }
+
+private:
+  uint16_t W = 0, H = 0;
+  uint8_t *shown = nullptr;
+  ChangeList list;
+  bool enabled = true;
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <Arduino.h>
+
+// Integer trig for animation and motion. Angles are 8-bit (256 = full turn),
+// results are Q8 (-255..255 ~ -1.0..1.0). No floats anywhere.
+
+static const uint8_t SIN_QUARTER[65] = {
+    0,   6,  13,  19,  25,  31,  37,  44,  50,  56,  62,  68,  74,  80,  86,  92,
+   98, 103, 109, 115, 120, 126, 131, 136, 142, 147, 152, 157, 162, 167, 171, 176,
+  180, 185, 189, 193, 197, 201, 205, 208, 212, 215, 219, 222, 225, 228, 231, 233,
+  236, 238, 240, 242, 244, 246, 247, 249, 250, 251, 252, 253, 254, 254, 255, 255,
+  255
+};
+
+static inline int16_t isin8(uint8_t a) {
+  uint8_t q = a & 63;
+  switch (a >> 6) {
+    case 0:  return  SIN_QUARTER[q];
+    case 1:  return  SIN_QUARTER[64 - q];
+    case 2:  return -SIN_QUARTER[q];
+    default: return -SIN_QUARTER[64 - q];
+  }
+}
+
+static inline int16_t icos8(uint8_t a) {
+  return isin8((uint8_t)(a + 64));
+}
+
+// Angle of (x, y) in the same 8-bit units, within one unit, for |x|, |y|
+// below 2^23. Octant fold plus atan(t) ~ t * pi/4 + 0.273 * t * (1 - t).
+static inline uint8_t iatan2(int32_t y, int32_t x) {
+  if (!x && !y) return 0;
+  int32_t ax = x < 0 ? -x : x, ay = y < 0 ? -y : y;
+  bool steep = ay > ax;
+  int32_t t = steep ? (ax << 8) / ay : (ay << 8) / ax;     // Q8, 0..256
+  int32_t a = (32 * t + ((11 * t * (256 - t)) >> 8) + 128) >> 8;
+  if (steep) a = 64 - a;
+  if (x < 0) a = 128 - a;
+  if (y < 0) a = -a;
+  return (uint8_t)a;
+}
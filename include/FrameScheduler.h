@@ -0,0 +1,88 @@
+#pragma once
+#include <Arduino.h>
+
+// Frame pacing, and how to spend the time left over between frames.
+//
+// Pure bookkeeping on timestamps the caller passes in (no clock reads, no
+// sleeping), so it runs the same against micros() or a fake clock.
+//
+// Without power saving every frame is FAST_US long and the rest is simply
+// waited out. With it, the frame period follows how much of the screen is
+// changing: dirty tiles are scaled to a 60 fps frame's worth (so a slower
+// rate isn't mistaken for a busier one), BUSY_TILES or more keeps 60 fps,
+// anything less runs at CALM_US, and QUIET_FRAMES frames in a row with
+// nothing to push drop to IDLE_US. Waits of SLEEP_MIN_US or more are worth
+// a light sleep; shorter ones aren't.
+//
+// Active (frame work) and idle (waiting) time are kept as running averages
+// per frame, 1/8 weight, for duty() to report.
+class FrameScheduler {
+public:
+  static constexpr uint32_t FAST_US = 16667;   // 60 fps
+  static constexpr uint32_t CALM_US = 33333;   // 30 fps
+  static constexpr uint32_t IDLE_US = 100000;  // 10 fps
+  static constexpr uint16_t BUSY_TILES = 4;    // per 60 fps frame
+  static constexpr uint8_t  QUIET_FRAMES = 8;
+  static constexpr uint32_t SLEEP_MIN_US = 2000;
+
+  void setPowerSave(bool on) {
+    powerSave = on;
+    period = FAST_US;
+    quiet = 0;
+  }
+
+  bool powerSaving() const { return powerSave; }
+
+  // A frame's work starts
+  void beginFrame(uint32_t nowUs) {
+    // whatever passed since the last endFrame() was idle
+    if (ended) idleAvg += ((int32_t)(nowUs - endUs) - idleAvg) / 8;
+    startUs = nowUs;
+  }
+
+  // The frame's work is done and `tiles` dirty tiles went out. Returns how
+  // long to wait before the next frame starts, us (0 = start it now).
+  uint32_t endFrame(uint32_t nowUs, uint16_t tiles) {
+    uint32_t active = nowUs - startUs;
+    activeAvg += ((int32_t)active - activeAvg) / 8;
+    endUs = nowUs;
+    ended = true;
+
+    if (powerSave) choosePeriod(tiles);
+    return active < period ? period - active : 0;
+  }
+
+  // Is a wait this long worth sleeping through?
+  bool shouldSleep(uint32_t waitUs) const {
+    return powerSave && waitUs >= SLEEP_MIN_US;
+  }
+
+  uint32_t periodUs() const { return period; }
+  uint32_t activeUs() const { return (uint32_t)activeAvg; }
+  uint32_t idleUs() const { return (uint32_t)idleAvg; }
+
+  // Share of the time spent doing frame work, per mille
+  uint16_t duty() const {
+    uint32_t total = (uint32_t)activeAvg + (uint32_t)idleAvg;
+    return total ? (uint16_t)((uint64_t)activeAvg * 1000 / total) : 1000;
+  }
+
+private:
+  void choosePeriod(uint16_t tiles) {
+    // Q4 tiles per 60 fps frame
+    uint32_t load = ((uint32_t)tiles << 4) * FAST_US / period;
+    if (tiles) quiet = 0;
+    else if (quiet < QUIET_FRAMES) quiet++;
+
+    if (load >= ((uint32_t)BUSY_TILES << 4)) period = FAST_US;
+    else if (quiet < QUIET_FRAMES) period = CALM_US;
+    else period = IDLE_US;
+  }
+
+  bool powerSave = false;
+  uint32_t period = FAST_US;
+  uint8_t quiet = 0;             // frames in a row with nothing pushed
+  uint32_t startUs = 0, endUs = 0;
+  bool ended = false;
+  int32_t activeAvg = 0, idleAvg = 0;
+};
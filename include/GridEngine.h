@@ -0,0 +1,301 @@
+#pragma once
+#include <Arduino.h>
+#include "DirtyTiles.h"
+#include "ChangeList.h"
+#include "BitPlane.h"
+#include "Districts.h"
+#include "LandUse.h"
+
+// Shared base for city generator engines. Owns what every engine renders
+// through: the intensity grid, the glow layer, dirty tiles, the optional
+// change list, the district map (engines add a site for each centre they
+// found), the land-use plane the renderer tints by and an intensity
+// histogram, plus a seeded PRNG so a run is reproducible from reset(seed).
+//
+// There are no virtual functions. An engine derives from this and provides
+//   void reset(uint32_t seed);
+//   void step();
+// and EngineHost (Engines.h) calls those on the concrete type, so the
+// step loop is inlined per engine. Everything the frame loop reads (data(),
+// glowData(), dirtyTiles(), updateGlow()) lives here and needs no dispatch.
+class GridEngine {
+public:
+  GridEngine(uint16_t w, uint16_t h)
+  : W(w), H(h) {
+    grid = (uint8_t*)malloc(W * H);
+    hblur = (uint8_t*)malloc(W * H);
+    glow = (uint8_t*)malloc(W * H);
+    colSum = (uint16_t*)malloc(W * sizeof(uint16_t));
+    dirty.init(W, H);
+    districts.init(W, H);
+    land.init(W, H);
+    clearGrid();
+  }
+
+  GridEngine(const GridEngine &) = delete;
+  GridEngine &operator=(const GridEngine &) = delete;
+
+  ~GridEngine() {
+    if (grid) free(grid);
+    if (hblur) free(hblur);
+    if (glow) free(glow);
+    if (colSum) free(colSum);
+  }
+
+  bool valid() const { return grid != nullptr && districts.valid(); }
+
+  uint8_t get(uint16_t x, uint16_t y) const {
+    return grid[y * W + x];
+  }
+
+  // Raw row-major intensity buffer (W*H bytes) for bulk conversion
+  const uint8_t *data() const { return grid; }
+
+  // Ambient glow layer: a box-blurred copy of the grid, same layout.
+  // nullptr if it couldn't be allocated.
+  const uint8_t *glowData() const { return (hblur && glow && colSum) ? glow : nullptr; }
+
+  // Optional sink for every changed cell index (e.g. FadeBuffer::pending());
+  // whole-grid changes are reported as an overflow
+  void setChangeList(ChangeList *c) { changes = c; }
+
+  // Voronoi districts around the centres the engine has founded
+  const DistrictMap &districtMap() const { return districts; }
+
+  // Land-use class per cell, 2 bits packed; all LAND_NONE unless the engine
+  // zones its city. Check valid() before reading.
+  const LandUse &landUse() const { return land; }
+
+  // Tiles touched since the last clearDirty(). After updateGlow() this also
+  // covers the tiles the glow spread into.
+  const DirtyTiles &dirtyTiles() const { return dirty; }
+  void clearDirty() { dirty.clear(); }
+
+  // Bring the glow layer up to date for everything dirtied since the last
+  // call. Separable box blur with running sums, restricted to dirty tiles
+  // (plus the blur radius), so cost follows how much changed. Call once per
+  // frame after stepping.
+  void updateGlow() { updateGlow(grid, dirty); }
+
+  // The same from another W*H intensity layer, e.g. what is on screen while
+  // changes fade in (so a halo fades in with its road): blurs src over the
+  // tiles marked in where, then grows where by the glow's reach
+  void updateGlow(const uint8_t *src, DirtyTiles &where) {
+    if (!glowData() || !where.any()) return;
+
+    // Horizontal pass first for every dirty run; the vertical pass reads
+    // hblur rows belonging to neighbouring tile rows.
+    for (uint8_t ty = 0; ty < where.tileRows(); ty++) {
+      DirtyTiles::forEachRun(where.row(ty), [&](uint8_t tx0, uint8_t tx1) {
+        int16_t y0 = ty * DirtyTiles::TILE;
+        int16_t y1 = min<int16_t>(H - 1, y0 + DirtyTiles::TILE - 1);
+        int16_t x0 = max<int16_t>(0, tx0 * DirtyTiles::TILE - GLOW_R);
+        int16_t x1 = min<int16_t>(W - 1, (tx1 + 1) * DirtyTiles::TILE - 1 + GLOW_R);
+        for (int16_t y = y0; y <= y1; y++) blurRow(src, y, x0, x1);
+      });
+    }
+
+    for (uint8_t ty = 0; ty < where.tileRows(); ty++) {
+      DirtyTiles::forEachRun(where.row(ty), [&](uint8_t tx0, uint8_t tx1) {
+        int16_t y0 = max<int16_t>(0, ty * DirtyTiles::TILE - GLOW_R);
+        int16_t y1 = min<int16_t>(H - 1, ty * DirtyTiles::TILE + DirtyTiles::TILE - 1 + GLOW_R);
+        int16_t x0 = max<int16_t>(0, tx0 * DirtyTiles::TILE - GLOW_R);
+        int16_t x1 = min<int16_t>(W - 1, (tx1 + 1) * DirtyTiles::TILE - 1 + GLOW_R);
+        blurCols(x0, x1, y0, y1);
+      });
+    }
+
+    // Glow reaches GLOW_R pixels past what changed
+    where.dilate();
+  }
+
+  // Intensity histogram, kept current by every write helper below (O(1)
+  // per cell changed, O(256) per decay) so the city's look can be judged
+  // without scanning the grid
+  const uint16_t *histogram() const { return hist; }
+
+  // Cells at or above intensity v
+  uint32_t cellsAtLeast(uint8_t v) const {
+    uint32_t n = 0;
+    for (uint16_t i = v; i < 256; i++) n += hist[i];
+    return n;
+  }
+
+  // Per mille of the grid lit at all (roads and up) / blown out to white
+  uint16_t coverage() const { return cellsAtLeast(COVER_LEVEL) * 1000UL / ((uint32_t)W * H); }
+  uint16_t saturation() const { return cellsAtLeast(SATURATED_LEVEL) * 1000UL / ((uint32_t)W * H); }
+  uint8_t meanIntensity() const { return total / ((uint32_t)W * H); }
+
+  static constexpr uint8_t COVER_LEVEL = 10;        // the palette's road band
+  static constexpr uint8_t SATURATED_LEVEL = 240;
+
+  // FNV-1a over the grid: the golden value a fixed seed must reproduce
+  uint32_t hash() const {
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < (uint32_t)W * H; i++) {
+      h = (h ^ grid[i]) * 16777619u;
+    }
+    return h;
+  }
+
+  uint16_t width()  const { return W; }
+  uint16_t height() const { return H; }
+
+  // The engine has nothing left to grow (its steps no longer change the
+  // grid); ResetPolicy starts a new city soon after
+  bool finished() const { return done; }
+
+protected:
+  // xorshift32; never seeded with 0 (that's its fixed point)
+  void seedRandom(uint32_t seed) { rng = seed ? seed : 0x9E3779B9u; }
+
+  inline uint32_t rand32() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+  }
+
+  // Blank grid, glow, districts and land use; everything is dirty and any
+  // change list overflows
+  void clearGrid() {
+    done = false;
+    districts.clear();
+    land.clear();
+    if (!grid) return;
+    memset(grid, 0, W * H);
+    memset(hist, 0, sizeof(hist));
+    hist[0] = W * H;
+    total = 0;
+    if (hblur) memset(hblur, 0, W * H);
+    if (glow) memset(glow, 0, W * H);
+    dirty.markAll();
+    if (changes) changes->setOverflow();
+  }
+
+  void addIntensity(int16_t x, int16_t y, uint8_t amt) {
+    uint16_t idx = (uint16_t)y * W + (uint16_t)x;
+    uint8_t old = grid[idx];
+    uint16_t v = old + amt;
+    uint8_t nv = (v > 255) ? 255 : (uint8_t)v;
+    grid[idx] = nv;
+    hist[old]--;
+    hist[nv]++;
+    total += nv - old;
+    dirty.mark(x, y);
+    if (changes) changes->add(idx);
+  }
+
+  // Overwrite a cell, for engines that compute intensity rather than add it
+  void setIntensity(int16_t x, int16_t y, uint8_t v) {
+    uint16_t idx = (uint16_t)y * W + (uint16_t)x;
+    uint8_t old = grid[idx];
+    if (old == v) return;
+    grid[idx] = v;
+    hist[old]--;
+    hist[v]++;
+    total += (int32_t)v - old;
+    dirty.mark(x, y);
+    if (changes) changes->add(idx);
+  }
+
+  // Round glow, stronger in the centre. Cells set in skip are left alone.
+  void bloom(int16_t cx, int16_t cy, uint8_t radius, uint8_t strength,
+             const BitPlane *skip = nullptr) {
+    for (int16_t y = -radius; y <= radius; y++) {
+      for (int16_t x = -radius; x <= radius; x++) {
+        int16_t px = cx + x;
+        int16_t py = cy + y;
+        if (px < 1 || px >= (int16_t)W-1 || py < 1 || py >= (int16_t)H-1) continue;
+        int16_t d2 = x*x + y*y;
+        if (d2 > radius*radius) continue;
+        if (skip && skip->test(px, py)) continue;
+
+        // stronger in center
+        uint8_t add = strength - (uint8_t)(min<int16_t>(strength, d2 * 3));
+        addIntensity(px, py, add);
+      }
+    }
+  }
+
+  void decay(uint8_t amt) {
+    if (!amt) return;
+    for (uint32_t i = 0; i < (uint32_t)W * H; i++) {
+      uint8_t v = grid[i];
+      grid[i] = (v > amt) ? (v - amt) : 0;
+    }
+    // every bin slides down by amt; the bottom amt bins land on 0
+    for (uint16_t i = 1; i < 256; i++) {
+      uint16_t n = hist[i];
+      if (!n) continue;
+      hist[i] = 0;
+      uint8_t to = (i > amt) ? i - amt : 0;
+      hist[to] += n;
+      total -= (uint32_t)n * (i - to);
+    }
+    dirty.markAll();
+    if (changes) changes->setOverflow();
+  }
+
+  const uint16_t W, H;
+  uint8_t *grid = nullptr;
+  DirtyTiles dirty;
+  ChangeList *changes = nullptr;
+  DistrictMap districts;
+  LandUse land;
+  uint16_t hist[256] = {};       // cells per intensity
+  uint32_t total = 0;            // sum of the grid
+  bool done = false;             // see finished()
+
+private:
+  // hblur[y][x0..x1] = mean of src[y][x-R..x+R] (zero outside the grid)
+  void blurRow(const uint8_t *src, int16_t y, int16_t x0, int16_t x1) {
+    const uint8_t *g = src + (uint32_t)y * W;
+    uint8_t *out = hblur + (uint32_t)y * W;
+    uint16_t sum = 0;
+    for (int16_t x = x0 - GLOW_R; x <= x0 + GLOW_R; x++) {
+      if (x >= 0 && x < (int16_t)W) sum += g[x];
+    }
+    for (int16_t x = x0; x <= x1; x++) {
+      out[x] = (uint8_t)(((uint32_t)sum * GLOW_RECIP) >> 16);
+      int16_t add = x + GLOW_R + 1, sub = x - GLOW_R;
+      if (add < (int16_t)W) sum += g[add];
+      if (sub >= 0) sum -= g[sub];
+    }
+  }
+
+  // glow[y0..y1][x0..x1] = mean of hblur over y-R..y+R, walked row by row
+  // with per-column running sums so memory access stays sequential
+  void blurCols(int16_t x0, int16_t x1, int16_t y0, int16_t y1) {
+    for (int16_t x = x0; x <= x1; x++) colSum[x] = 0;
+    for (int16_t y = y0 - GLOW_R; y <= y0 + GLOW_R; y++) {
+      if (y < 0 || y >= (int16_t)H) continue;
+      const uint8_t *hb = hblur + (uint32_t)y * W;
+      for (int16_t x = x0; x <= x1; x++) colSum[x] += hb[x];
+    }
+    for (int16_t y = y0; y <= y1; y++) {
+      uint8_t *out = glow + (uint32_t)y * W;
+      for (int16_t x = x0; x <= x1; x++) {
+        out[x] = (uint8_t)(((uint32_t)colSum[x] * GLOW_RECIP) >> 16);
+      }
+      int16_t add = y + GLOW_R + 1, sub = y - GLOW_R;
+      if (add < (int16_t)H) {
+        const uint8_t *hb = hblur + (uint32_t)add * W;
+        for (int16_t x = x0; x <= x1; x++) colSum[x] += hb[x];
+      }
+      if (sub >= 0) {
+        const uint8_t *hb = hblur + (uint32_t)sub * W;
+        for (int16_t x = x0; x <= x1; x++) colSum[x] -= hb[x];
+      }
+    }
+  }
+
+  // Glow layer: horizontal pass buffer, final glow, per-column scratch sums
+  static constexpr int16_t  GLOW_R = 4;                            // 9x9 box
+  static constexpr uint32_t GLOW_RECIP = 65536 / (2 * GLOW_R + 1) + 1;
+  uint8_t  *hblur = nullptr;
+  uint8_t  *glow = nullptr;
+  uint16_t *colSum = nullptr;
+
+  uint32_t rng = 1;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <Arduino.h>
+#include "BitPlane.h"
+#include "DirtyTiles.h"
+
+// Land-use classes as the renderer sees them; each picks its own 256-entry
+// color table (see PaletteBank)
+enum LandClass : uint8_t {
+  LAND_NONE = 0,
+  LAND_RES,        // housing: white lights
+  LAND_COM,        // commerce: cool, bright
+  LAND_IND,        // industry: orange
+  LAND_CLASSES
+};
+
+// One LandClass per cell at 2 bits, 16 cells to a 32-bit word (240 wide ->
+// 15 words per row, 240x135 -> 8100 bytes). Cell x sits at bits
+// 2*(x & 15) of word x >> 4, so a 16-pixel dirty tile is exactly one word.
+class LandUse {
+public:
+  LandUse() = default;
+  LandUse(const LandUse &) = delete;
+  LandUse &operator=(const LandUse &) = delete;
+
+  ~LandUse() {
+    if (words) free(words);
+  }
+
+  bool init(uint16_t w, uint16_t h) {
+    W = w; H = h;
+    stride = (w + 15) >> 4;
+    words = (uint32_t*)malloc((size_t)stride * h * sizeof(uint32_t));
+    clear();
+    return valid();
+  }
+
+  bool valid() const { return words != nullptr; }
+
+  void clear() {
+    if (words) memset(words, 0, (size_t)stride * H * sizeof(uint32_t));
+  }
+
+  inline uint8_t get(uint16_t x, uint16_t y) const {
+    return (words[y * stride + (x >> 4)] >> ((x & 15) * 2)) & 3;
+  }
+
+  inline void set(uint16_t x, uint16_t y, uint8_t cls) {
+    uint32_t &w = words[y * stride + (x >> 4)];
+    uint8_t s = (x & 15) * 2;
+    w = (w & ~(3u << s)) | ((uint32_t)cls << s);
+  }
+
+  // Rewrite the whole plane from one bitplane per class (LAND_RES,
+  // LAND_COM, LAND_IND; cells in none are LAND_NONE). Each half of a
+  // bitplane word is spread into one packed word. Tiles whose word changed
+  // are marked in dirty.
+  void pack(const BitPlane &res, const BitPlane &com, const BitPlane &ind, DirtyTiles &dirty) {
+    for (uint16_t y = 0; y < H; y++) {
+      const uint32_t *r = res.row(y), *c = com.row(y), *i = ind.row(y);
+      uint32_t *out = row(y);
+      for (uint16_t w = 0; w < stride; w++) {
+        uint8_t half = (w & 1) * 16;
+        uint32_t rw = r[w >> 1] >> half, cw = c[w >> 1] >> half, iw = i[w >> 1] >> half;
+        // class bit 0: housing or industry; bit 1: commerce or industry
+        uint32_t packed = spread((rw | iw) & 0xFFFF) | (spread((cw | iw) & 0xFFFF) << 1);
+        if (packed == out[w]) continue;
+        out[w] = packed;
+        dirty.mark(w << 4, y);
+      }
+    }
+  }
+
+  uint32_t *row(uint16_t y) { return words + (uint32_t)y * stride; }
+  const uint32_t *row(uint16_t y) const { return words + (uint32_t)y * stride; }
+  uint16_t wordsPerRow() const { return stride; }
+
+private:
+  // Bits 0..15 of v to the even bits 0..30
+  static inline uint32_t spread(uint32_t v) {
+    v = (v | (v << 8)) & 0x00FF00FFu;
+    v = (v | (v << 4)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+    return v;
+  }
+
+  uint16_t W = 0, H = 0, stride = 0;
+  uint32_t *words = nullptr;
+};
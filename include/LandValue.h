@@ -0,0 +1,96 @@
+#pragma once
+#include <Arduino.h>
+
+// Coarse land value: one byte per 8x8-pixel cell (30x17 on the T-Display).
+//
+// A cell's own worth is the light under it, which is where roads and bright
+// nodes deposit; on top of that it keeps KEEP/256 of its 4 neighbours'
+// average, so value spreads out from the city and fades with distance. The
+// core saturates, the outskirts sit low, untouched country stays at 0.
+//
+// update() refreshes a fixed number of cells round-robin (64 pixel reads
+// and 4 neighbour reads each), in place, so the cost per call is bounded
+// and a full sweep takes cols * rows / n calls. gain() turns a value into
+// a Q8 factor through a small table for agents to scale their chances by.
+class LandValue {
+public:
+  static constexpr uint8_t CELL_SHIFT = 3;
+
+  LandValue() = default;
+  LandValue(const LandValue &) = delete;
+  LandValue &operator=(const LandValue &) = delete;
+
+  ~LandValue() {
+    if (value) free(value);
+  }
+
+  bool init(uint16_t w, uint16_t h) {
+    W = w; H = h;
+    cols = (w + (1 << CELL_SHIFT) - 1) >> CELL_SHIFT;
+    rows = (h + (1 << CELL_SHIFT) - 1) >> CELL_SHIFT;
+    value = (uint8_t*)malloc((size_t)cols * rows);
+    clear();
+    return valid();
+  }
+
+  bool valid() const { return value != nullptr; }
+
+  void clear() {
+    if (value) memset(value, 0, (size_t)cols * rows);
+    cursor = 0;
+  }
+
+  // Refresh the next n cells from the grid (W*H bytes)
+  void update(const uint8_t *grid, uint16_t n) {
+    const uint16_t cells = (uint16_t)cols * rows;
+    for (uint16_t i = 0; i < n; i++) {
+      refresh(grid, cursor % cols, cursor / cols);
+      cursor = (cursor + 1) % cells;
+    }
+  }
+
+  uint8_t at(int16_t x, int16_t y) const {
+    return value[(y >> CELL_SHIFT) * cols + (x >> CELL_SHIFT)];
+  }
+
+  uint8_t atCell(uint8_t cx, uint8_t cy) const { return value[cy * cols + cx]; }
+
+  // Q8 factor for a value: 0.25x in empty country up to 2x downtown
+  static uint16_t gain(uint8_t v) { return GAIN[v >> 4]; }
+
+  uint8_t cellCols() const { return cols; }
+  uint8_t cellRows() const { return rows; }
+
+private:
+  static constexpr uint16_t KEEP = 200;     // Q8 share of the neighbours kept
+  static constexpr uint16_t GAIN[16] = {
+    64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 480, 496, 512,
+  };
+
+  void refresh(const uint8_t *grid, uint8_t cx, uint8_t cy) {
+    int16_t x0 = cx << CELL_SHIFT, y0 = cy << CELL_SHIFT;
+    int16_t x1 = min<int16_t>(W, x0 + (1 << CELL_SHIFT));
+    int16_t y1 = min<int16_t>(H, y0 + (1 << CELL_SHIFT));
+    uint16_t sum = 0;
+    for (int16_t y = y0; y < y1; y++) {
+      const uint8_t *g = grid + (uint32_t)y * W;
+      for (int16_t x = x0; x < x1; x++) sum += g[x];
+    }
+    uint16_t own = sum / ((x1 - x0) * (y1 - y0)) / 2;
+
+    // missing neighbours at the screen edge count as empty country
+    uint16_t near = 0;
+    if (cx > 0) near += value[cy * cols + cx - 1];
+    if (cx + 1 < cols) near += value[cy * cols + cx + 1];
+    if (cy > 0) near += value[(cy - 1) * cols + cx];
+    if (cy + 1 < rows) near += value[(cy + 1) * cols + cx];
+
+    uint32_t v = own + ((uint32_t)near * KEEP >> 10);
+    value[cy * cols + cx] = v > 255 ? 255 : (uint8_t)v;
+  }
+
+  uint16_t W = 0, H = 0;
+  uint8_t cols = 0, rows = 0;
+  uint8_t *value = nullptr;
+  uint16_t cursor = 0;
+};
@@ -0,0 +1,181 @@
+#pragma once
+#include <Arduino.h>
+#include "FixedMath.h"
+#include "LandUse.h"
+
+// Intensity -> RGB565 lookups used by the frame conversion loop.
+// Final tables are kept byte-swapped so they can be stored straight into the
+// 16-bit sprite buffer (TFT_eSprite keeps its pixels in panel byte order).
+
+static constexpr uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b) {
+  return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+static constexpr uint16_t swap565(uint16_t c) {
+  return (uint16_t)((c >> 8) | (c << 8));
+}
+
+// Scale an RGB565 color by a Q8 factor (256 = unchanged), saturating.
+static inline uint16_t scale565(uint16_t c, uint16_t q8) {
+  uint32_t r = ((c >> 11) & 0x1F) * q8 >> 8;
+  uint32_t g = ((c >> 5)  & 0x3F) * q8 >> 8;
+  uint32_t b = ( c        & 0x1F) * q8 >> 8;
+  if (r > 0x1F) r = 0x1F;
+  if (g > 0x3F) g = 0x3F;
+  if (b > 0x1F) b = 0x1F;
+  return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// Animates the palette instead of the grid: shimmer in the warm "city
+// lights" band and a slow pulse in the road glow band. Nothing in the sim
+// is touched; each update rebuilds one 256-entry table (512 bytes).
+class PaletteAnimator {
+public:
+  static constexpr uint8_t ROAD_LO = 10;   // matches the satellite bands
+  static constexpr uint8_t WARM_LO = 80;
+
+  // base is plain (unswapped) RGB565, 256 entries
+  void setBase(const uint16_t *b) {
+    base = b;
+    rebuild(lastMs);
+  }
+
+  void setEnabled(bool on) {
+    enabled = on;
+    rebuild(lastMs);
+  }
+  bool isEnabled() const { return enabled; }
+
+  // Rebuild the animated table for the given time
+  void update(uint32_t nowMs) {
+    lastMs = nowMs;
+    if (enabled) rebuild(nowMs);
+  }
+
+  // Animated colors, plain RGB565
+  const uint16_t *colors() const { return live; }
+
+private:
+  void rebuild(uint32_t nowMs) {
+    if (!base) return;
+
+    if (!enabled) {
+      memcpy(live, base, sizeof(live));
+      return;
+    }
+
+    // ~5s road pulse, ~1.3s twinkle, ~20s hue drift
+    uint8_t pulsePhase   = (uint8_t)(nowMs / 20);
+    uint8_t twinklePhase = (uint8_t)(nowMs / 5);
+    uint8_t huePhase     = (uint8_t)(nowMs / 80);
+
+    uint16_t roadScale = 256 + (ROAD_PULSE_AMP * isin8(pulsePhase) >> 8);
+
+    for (uint16_t v = 0; v < 256; v++) {
+      uint16_t c = base[v];
+
+      if (v >= WARM_LO) {
+        // Neighbouring intensities get unrelated phases, so adjacent lights
+        // twinkle independently rather than the whole band flashing together.
+        uint8_t ph = (uint8_t)(twinklePhase + v * 37);
+        uint16_t s = 256 + (TWINKLE_AMP * isin8(ph) >> 8);
+        c = scale565(c, s);
+
+        // Slow warm/cool drift: trade a little red for blue and back.
+        int16_t shift = isin8((uint8_t)(huePhase + v)) * 3 / 255;  // -3..3
+        int16_t r = (int16_t)((c >> 11) & 0x1F) + shift;
+        int16_t b = (int16_t)(c & 0x1F) - shift;
+        r = constrain(r, 0, 0x1F);
+        b = constrain(b, 0, 0x1F);
+        c = (uint16_t)((r << 11) | (c & 0x07E0) | b);
+      } else if (v >= ROAD_LO) {
+        c = scale565(c, roadScale);
+      }
+
+      live[v] = c;
+    }
+  }
+
+  static constexpr int16_t ROAD_PULSE_AMP = 40;  // Q8, ~±15%
+  static constexpr int16_t TWINKLE_AMP    = 56;  // Q8, ~±22%
+
+  const uint16_t *base = nullptr;
+  uint16_t live[256] = {};
+  bool enabled = true;
+  uint32_t lastMs = 0;
+};
+
+// Land-use tint for the lights band (v >= WARM_LO): Q8 channel gains and
+// a Q8 pull toward the color's own grey, so housing reads white, industry
+// orange and commerce a cool bright white. Roads and dark ground keep the
+// plain palette.
+static inline uint16_t landTint565(uint16_t c, uint8_t cls, uint8_t v) {
+  struct Tint { uint16_t r, g, b, grey; };
+  static constexpr Tint TINTS[LAND_CLASSES] = {
+    {256, 256, 256, 0},     // none
+    {272, 272, 272, 200},   // housing
+    {216, 256, 380, 96},    // commerce
+    {300, 190, 90, 0},      // industry
+  };
+  if (cls == LAND_NONE || v < PaletteAnimator::WARM_LO) return c;
+  const Tint &t = TINTS[cls];
+  uint32_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+  uint32_t grey = (r * 2 + g + b * 2) / 3;      // in 6-bit green units
+  r = ((r * 2 * (256 - t.grey) + grey * t.grey) >> 8) * t.r >> 9;
+  g = ((g * (256 - t.grey) + grey * t.grey) >> 8) * t.g >> 8;
+  b = ((b * 2 * (256 - t.grey) + grey * t.grey) >> 8) * t.b >> 9;
+  if (r > 0x1F) r = 0x1F;
+  if (g > 0x3F) g = 0x3F;
+  if (b > 0x1F) b = 0x1F;
+  return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// The tables the conversion loop actually reads: one byte-swapped LUT per
+// lookup group (a coarse screen region, see DayNight.h) and land-use class,
+// derived from the animated colors with a per-group, per-intensity Q8 shade
+// and the class tint. A group's tables are contiguous, class-major, so the
+// conversion loop indexes lut(group)[(cls << 8) | v]. 4 x 4 x 512 bytes,
+// plus 2.5 KB of build inputs kept to skip entries that didn't change.
+static constexpr uint8_t LUT_GROUPS = 4;
+
+class PaletteBank {
+public:
+  // Intensities are reported in bands of 8 (bit v >> BAND_SHIFT)
+  static constexpr uint8_t BAND_SHIFT = 3;
+
+  // shade(group, v) -> Q8 scale. Only entries whose color or shade moved
+  // since the last build are recomputed, and a group with the same shade as
+  // the one before copies its entries. Returns the bands with any entry
+  // changed, in any group or class (0 = nothing to redraw).
+  template <class Shade>
+  uint32_t build(const uint16_t *colors, Shade shade) {
+    uint32_t changed = 0;
+    for (uint8_t g = 0; g < LUT_GROUPS; g++) {
+      for (uint16_t v = 0; v < 256; v++) {
+        uint16_t s = shade(g, (uint8_t)v);
+        if (primed && s == shades[g][v] && colors[v] == inputs[v]) continue;
+        shades[g][v] = s;
+        // groups mostly agree on a shade: reuse the previous group's entries
+        bool same = g > 0 && s == shades[g - 1][v];
+        uint16_t base = same ? 0 : scale565(colors[v], s);
+        for (uint8_t cls = 0; cls < LAND_CLASSES; cls++) {
+          uint16_t c = same ? tables[g - 1][cls][v] : swap565(landTint565(base, cls, (uint8_t)v));
+          uint16_t &t = tables[g][cls][v];
+          if (t != c) { t = c; changed |= 1u << (v >> BAND_SHIFT); }
+        }
+      }
+    }
+    memcpy(inputs, colors, sizeof(inputs));
+    primed = true;
+    return changed;
+  }
+
+  // 256 * LAND_CLASSES entries, class-major
+  const uint16_t *lut(uint8_t group) const { return tables[group][0]; }
+
+private:
+  uint16_t tables[LUT_GROUPS][LAND_CLASSES][256] = {};
+  uint16_t inputs[256] = {};              // colors of the last build
+  uint16_t shades[LUT_GROUPS][256] = {};  // and their shades
+  bool primed = false;
+};
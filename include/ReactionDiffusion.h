@@ -0,0 +1,260 @@
+#pragma once
+#include <Arduino.h>
+#include "GridEngine.h"
+
+// Gray-Scott reaction-diffusion engine: districts grow as organic,
+// cell-like blobs out of a few seed spots instead of being walked.
+//
+// The chemicals live at half resolution (one cell per 2x2 pixels) as
+// 16-bit fixed point, 4096 = 1.0. The update is done in place, one row at a time:
+// before a row is overwritten its old values are copied into one of two
+// rolling row buffers, which is all the 3x3 Laplacian needs from above.
+//
+// Only active tiles are stepped. A tile where nothing changed, and whose
+// neighbours didn't change either, would compute exactly what it already
+// holds, so skipping it is exact for empty background. Tiles that only
+// drift by a few LSBs are let settle too, so the step cost follows the
+// growth front rather than the size of the city.
+//
+// Host builds (SSE2 or NEON) step 4 cells at a time with GCC vector
+// extensions; the ESP32 has no SIMD unit for this and runs the scalar loop.
+// Both give the same result bit for bit (test/host/test_reaction_simd.cpp).
+#ifndef RD_SIMD
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define RD_SIMD 1
+#else
+#define RD_SIMD 0
+#endif
+#endif
+
+class ReactionDiffusion : public GridEngine {
+public:
+  ReactionDiffusion(uint16_t w, uint16_t h)
+  : GridEngine(w, h), RW((w + 1) / 2), RH((h + 1) / 2) {
+    u = (uint16_t*)malloc((size_t)RW * RH * sizeof(uint16_t));
+    v = (uint16_t*)malloc((size_t)RW * RH * sizeof(uint16_t));
+    rows = (uint16_t*)malloc((size_t)4 * RW * sizeof(uint16_t));
+    // activity tiles are 8x8 cells: DirtyTiles over the full-res size,
+    // marked at (2x, 2y)
+    active.init(w, h);
+    changed.init(w, h);
+  }
+
+  ~ReactionDiffusion() {
+    if (u) free(u);
+    if (v) free(v);
+    if (rows) free(rows);
+  }
+
+  bool valid() const { return GridEngine::valid() && u && v && rows; }
+
+  void reset(uint32_t seed) {
+    if (!valid()) return;
+    seedRandom(seed);
+    clearGrid();
+    for (uint32_t i = 0; i < (uint32_t)RW * RH; i++) { u[i] = ONE; v[i] = 0; }
+    active.clear();
+
+    // downtown plus a few outlying villages
+    seedSpot(RW / 2, RH / 2, 4);
+    uint8_t extra = 2 + (rand32() % 3);
+    for (uint8_t i = 0; i < extra; i++) seedSpot(4 + rand32() % (RW - 8), 4 + rand32() % (RH - 8), 2);
+
+    steps = 0;
+    nextSeedStep = SEED_EVERY + (rand32() % SEED_EVERY);
+  }
+
+  void step() {
+    steps++;
+    if (steps >= nextSeedStep) {
+      seedSpot(4 + rand32() % (RW - 8), 4 + rand32() % (RH - 8), 2);
+      nextSeedStep = steps + SEED_EVERY + (rand32() % SEED_EVERY);
+    }
+
+    changed.clear();
+    uint16_t *saveU[2] = {rows, rows + RW};
+    uint16_t *saveV[2] = {rows + 2 * RW, rows + 3 * RW};
+    const uint16_t *pu = nullptr, *pv = nullptr;   // old values of row y-1
+    uint8_t flip = 0;
+
+    for (uint16_t y = 0; y < RH; y++) {
+      uint16_t *ru = u + (uint32_t)y * RW, *rv = v + (uint32_t)y * RW;
+      uint16_t mask = active.row(y >> ACT_SHIFT);
+      if (!mask) {
+        // untouched this step, so the array row still holds old values
+        pu = ru; pv = rv;
+        continue;
+      }
+
+      uint16_t *cu = saveU[flip], *cv = saveV[flip];
+      flip ^= 1;
+      memcpy(cu, ru, RW * sizeof(uint16_t));
+      memcpy(cv, rv, RW * sizeof(uint16_t));
+      if (!pu) { pu = cu; pv = cv; }                 // mirror at the top
+      const uint16_t *nu = (y + 1 < RH) ? ru + RW : cu;
+      const uint16_t *nv = (y + 1 < RH) ? rv + RW : cv;
+
+      DirtyTiles::forEachRun(mask, [&](uint8_t tx0, uint8_t tx1) {
+        uint16_t x0 = tx0 << ACT_SHIFT;
+        uint16_t x1 = min<uint16_t>(RW - 1, ((tx1 + 1) << ACT_SHIFT) - 1);
+        updateSpan(y, x0, x1, pu, pv, cu, cv, nu, nv, ru, rv);
+      });
+      pu = cu; pv = cv;
+    }
+
+    // change spreads at most one cell per step, so one tile of margin
+    active = changed;
+    active.dilate();
+  }
+
+#if RD_SIMD
+  // Off = scalar loop only, to check or time the vector path against it
+  void setSimd(bool on) { simd = on; }
+#endif
+
+private:
+  // 4.12 rather than 8.8: with 8 fraction bits u*v*v rounds to zero for
+  // small v and growth fronts stall after a few cells
+  static constexpr uint8_t  FRAC = 12;
+  static constexpr uint16_t ONE = 1 << FRAC;         // 1.0
+  // 3x3 Laplacian weights in 1/256: edges 0.2, corners 0.05, centre -1
+  static constexpr int32_t  LAP_EDGE = 51, LAP_CORNER = 13;
+  // Feed and kill rates in Q16 ("coral" regime: spreading labyrinths)
+  static constexpr uint32_t FEED = 3572;             // 0.0545
+  static constexpr uint32_t KILL = 4063;             // 0.062
+  static constexpr uint32_t SEED_EVERY = 700;        // steps between new spots
+  static constexpr uint8_t  ACT_SHIFT = DirtyTiles::SHIFT - 1;
+  // A cell drifting by no more than this doesn't keep its tile awake.
+  // Finished labyrinth walls creep by a few LSBs forever; this lets them
+  // freeze while the growth front keeps running.
+  static constexpr int32_t  SETTLED = 2;
+
+  // New row y from the old rows above (p), at (c) and below (n)
+  void updateSpan(uint16_t y, uint16_t x0, uint16_t x1,
+                  const uint16_t *pu, const uint16_t *pv,
+                  const uint16_t *cu, const uint16_t *cv,
+                  const uint16_t *nu, const uint16_t *nv,
+                  uint16_t *ou, uint16_t *ov) {
+    uint16_t x = x0;
+#if RD_SIMD
+    if (simd) {
+      // the mirrored side columns stay scalar
+      if (x == 0) updateCell(y, x++, pu, pv, cu, cv, nu, nv, ou, ov);
+      for (; x + LANES <= x1 + 1 && x + LANES < RW; x += LANES) {
+        updateLanes(y, x, pu, pv, cu, cv, nu, nv, ou, ov);
+      }
+    }
+#endif
+    for (; x <= x1; x++) updateCell(y, x, pu, pv, cu, cv, nu, nv, ou, ov);
+  }
+
+  void updateCell(uint16_t y, uint16_t x,
+                  const uint16_t *pu, const uint16_t *pv,
+                  const uint16_t *cu, const uint16_t *cv,
+                  const uint16_t *nu, const uint16_t *nv,
+                  uint16_t *ou, uint16_t *ov) {
+    uint16_t l = x ? x - 1 : x;                      // mirror at the sides
+    uint16_t r = (x + 1 < RW) ? x + 1 : x;
+
+    int32_t lapU = (LAP_EDGE * (pu[x] + nu[x] + cu[l] + cu[r]) +
+                    LAP_CORNER * (pu[l] + pu[r] + nu[l] + nu[r]) -
+                    256 * (int32_t)cu[x]) / 256;
+    int32_t lapV = (LAP_EDGE * (pv[x] + nv[x] + cv[l] + cv[r]) +
+                    LAP_CORNER * (pv[l] + pv[r] + nv[l] + nv[r]) -
+                    256 * (int32_t)cv[x]) / 256;
+
+    uint32_t uvv = ((((uint32_t)cu[x] * cv[x]) >> FRAC) * cv[x]) >> FRAC;
+    int32_t du = lapU - (int32_t)uvv + (int32_t)((FEED * (ONE - cu[x]) + 0x8000) >> 16);
+    int32_t dv = lapV / 2 + (int32_t)uvv - (int32_t)(((FEED + KILL) * cv[x] + 0x8000) >> 16);
+    apply(y, x, cu[x], cv[x], du, dv, ou, ov);
+  }
+
+  // Write a cell's new values, wake its tile and show it
+  void apply(uint16_t y, uint16_t x, uint16_t cu, uint16_t cv, int32_t du, int32_t dv,
+             uint16_t *ou, uint16_t *ov) {
+    if (!du && !dv) return;
+    ou[x] = (uint16_t)constrain((int32_t)cu + du, (int32_t)0, (int32_t)ONE);
+    ov[x] = (uint16_t)constrain((int32_t)cv + dv, (int32_t)0, (int32_t)ONE);
+    if (abs(du) > SETTLED || abs(dv) > SETTLED) changed.mark(x * 2, y * 2);
+    show(x, y, ov[x]);
+  }
+
+#if RD_SIMD
+  static constexpr uint8_t LANES = 4;      // one 128-bit register of int32
+  typedef int32_t  Lanes   __attribute__((vector_size(LANES * sizeof(int32_t))));
+  typedef uint16_t Lanes16 __attribute__((vector_size(LANES * sizeof(uint16_t))));
+
+  static inline Lanes load(const uint16_t *p) {
+    Lanes16 h;
+    memcpy(&h, p, sizeof(h));
+    return __builtin_convertvector(h, Lanes);
+  }
+
+  // updateCell() for cells x..x+LANES-1, none on a side column. Every
+  // term is non-negative or fits int32 as in the scalar code, and vector
+  // division truncates the same way, so the lanes match it exactly.
+  void updateLanes(uint16_t y, uint16_t x,
+                   const uint16_t *pu, const uint16_t *pv,
+                   const uint16_t *cu, const uint16_t *cv,
+                   const uint16_t *nu, const uint16_t *nv,
+                   uint16_t *ou, uint16_t *ov) {
+    Lanes u = load(cu + x), v = load(cv + x);
+    Lanes lapU = (LAP_EDGE * (load(pu + x) + load(nu + x) + load(cu + x - 1) + load(cu + x + 1)) +
+                  LAP_CORNER * (load(pu + x - 1) + load(pu + x + 1) + load(nu + x - 1) + load(nu + x + 1)) -
+                  256 * u) / 256;
+    Lanes lapV = (LAP_EDGE * (load(pv + x) + load(nv + x) + load(cv + x - 1) + load(cv + x + 1)) +
+                  LAP_CORNER * (load(pv + x - 1) + load(pv + x + 1) + load(nv + x - 1) + load(nv + x + 1)) -
+                  256 * v) / 256;
+
+    Lanes uvv = (((u * v) >> FRAC) * v) >> FRAC;
+    Lanes du = lapU - uvv + (((int32_t)FEED * ((int32_t)ONE - u) + 0x8000) >> 16);
+    Lanes dv = lapV / 2 + uvv - (((int32_t)(FEED + KILL) * v + 0x8000) >> 16);
+
+    int32_t d[2][LANES];
+    memcpy(d[0], &du, sizeof(du));
+    memcpy(d[1], &dv, sizeof(dv));
+    for (uint8_t i = 0; i < LANES; i++) {
+      apply(y, x + i, cu[x + i], cv[x + i], d[0][i], d[1][i], ou, ov);
+    }
+  }
+#endif
+
+  // v ~ 0..0.4 in the pattern: stretch it to intensity over a 2x2 block
+  void show(uint16_t x, uint16_t y, uint16_t cv) {
+    uint8_t out = (uint8_t)min<uint32_t>(255, ((uint32_t)cv * 5 / 2) >> (FRAC - 8));
+    uint16_t px = x * 2, py = y * 2;
+    setIntensity(px, py, out);
+    if (px + 1 < W) setIntensity(px + 1, py, out);
+    if (py + 1 < H) {
+      setIntensity(px, py + 1, out);
+      if (px + 1 < W) setIntensity(px + 1, py + 1, out);
+    }
+  }
+
+  // Square of reagent with a little noise so it doesn't grow symmetric;
+  // each spot founds a district
+  void seedSpot(uint16_t cx, uint16_t cy, uint8_t r) {
+    districts.addSite(cx * 2, cy * 2);
+    for (int16_t y = (int16_t)cy - r; y <= (int16_t)cy + r; y++) {
+      for (int16_t x = (int16_t)cx - r; x <= (int16_t)cx + r; x++) {
+        if (x < 0 || y < 0 || x >= (int16_t)RW || y >= (int16_t)RH) continue;
+        uint32_t i = (uint32_t)y * RW + x;
+        u[i] = ONE / 2;
+        v[i] = ONE / 4 + (rand32() & (ONE / 16 - 1));
+        show(x, y, v[i]);
+      }
+    }
+    active.markRect(2 * (cx - r - 1), 2 * (cy - r - 1), 2 * (cx + r + 1), 2 * (cy + r + 1));
+  }
+
+  const uint16_t RW, RH;
+  uint16_t *u = nullptr, *v = nullptr;
+  uint16_t *rows = nullptr;        // 2 rolling rows each for u and v
+  DirtyTiles active;               // tiles to step (8x8 cells)
+  DirtyTiles changed;              // tiles that changed this step
+  uint32_t steps = 0;
+  uint32_t nextSeedStep = 0;
+#if RD_SIMD
+  bool simd = true;
+#endif
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <Arduino.h>
+#include "GridEngine.h"
+
+// Decides when to start a new city from how the current one looks, using
+// the engine's histogram metrics (no grid scans):
+//   saturated - too much of the screen has blown out to white
+//   stalled   - coverage and brightness haven't moved for STALL_MS, so the
+//               city is finished (burn-in is BurnInGuard's job, not this)
+//   finished  - the engine says it has nothing left to grow; the city is
+//               still shown for FINISHED_HOLD_MS
+//   aged      - a hard ceiling, for cities that creep along forever
+// Nothing fires in the first MIN_AGE_MS, and the metrics are looked at
+// once per CHECK_MS.
+class ResetPolicy {
+public:
+  enum Reason : uint8_t { KEEP = 0, SATURATED, STALLED, FINISHED, AGED };
+
+  static constexpr uint32_t CHECK_MS = 1000;
+  static constexpr uint32_t MIN_AGE_MS = 60UL * 1000;
+  static constexpr uint32_t STALL_MS = 3UL * 60 * 1000;
+  static constexpr uint32_t FINISHED_HOLD_MS = 15UL * 1000;
+  static constexpr uint32_t MAX_AGE_MS = 60UL * 60 * 1000;
+  static constexpr uint16_t SATURATION_LIMIT = 300;   // per mille
+  static constexpr uint16_t STALL_COVERAGE = 2;       // per mille of movement
+  static constexpr uint8_t  STALL_MEAN = 1;
+
+  // A new city just started
+  void start(uint32_t nowMs) {
+    startMs = lastCheckMs = stallMs = nowMs;
+    finishedMs = 0;
+    sawFinished = false;
+    stallCoverage = 0;
+    stallMean = 0;
+  }
+
+  Reason check(uint32_t nowMs, const GridEngine &g) {
+    if (nowMs - lastCheckMs < CHECK_MS) return KEEP;
+    lastCheckMs = nowMs;
+
+    uint16_t cov = g.coverage();
+    uint8_t mean = g.meanIntensity();
+    if (abs((int16_t)cov - (int16_t)stallCoverage) > STALL_COVERAGE ||
+        abs((int16_t)mean - (int16_t)stallMean) > STALL_MEAN) {
+      // still changing: restart the stall window from here
+      stallCoverage = cov;
+      stallMean = mean;
+      stallMs = nowMs;
+    }
+
+    if (g.finished() && !sawFinished) {
+      sawFinished = true;
+      finishedMs = nowMs;
+    }
+
+    uint32_t age = nowMs - startMs;
+    if (age < MIN_AGE_MS) return KEEP;
+    if (g.saturation() >= SATURATION_LIMIT) return SATURATED;
+    if (nowMs - stallMs >= STALL_MS) return STALLED;
+    if (sawFinished && nowMs - finishedMs >= FINISHED_HOLD_MS) return FINISHED;
+    if (age >= MAX_AGE_MS) return AGED;
+    return KEEP;
+  }
+
+  static const char *name(Reason r) {
+    static const char *const NAMES[] = {"keep", "saturated", "stalled", "finished", "aged"};
+    return NAMES[r];
+  }
+
+private:
+  uint32_t startMs = 0, lastCheckMs = 0, stallMs = 0;
+  uint16_t stallCoverage = 0;
+  uint8_t  stallMean = 0;
+  uint32_t finishedMs = 0;
+  bool sawFinished = false;
+};
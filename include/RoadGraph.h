@@ -0,0 +1,318 @@
+#pragma once
+#include <Arduino.h>
+#include "BitPlane.h"
+#include "UnionFind.h"
+
+// Road network as a graph, maintained incrementally as agents lay road.
+//
+// The graph lives on its own coarse cell grid (CitySim feeds it 8x8-pixel
+// road blocks: pixel roads here are so dense that a per-pixel graph is
+// mostly junctions and wouldn't fit in RAM). Road cells are a bitset. With
+// 4-neighbour connectivity a road cell with exactly two road neighbours is
+// a chain cell; anything else (dead end, junction, isolated dot) is a node.
+// An edge is the chain of cells between two nodes; its polyline isn't
+// stored, it is re-walked from the bitset on demand (forEachEdgeCell).
+//
+// Adding a cell only disturbs its 4-neighbourhood: edges through or ending
+// at those cells are dropped, node status is recomputed for the handful of
+// cells whose degree changed, and the affected nodes re-trace their open
+// directions. Work is proportional to the length of the chains touched,
+// never to the grid. rebuild() does the same from scratch as a batch pass.
+//
+// Connectivity is tracked alongside with a union-find over road cells: a
+// new cell joins the components of its road neighbours, so the number of
+// separate networks and the size of the biggest are always at hand.
+//
+// Tables are sized from the cell count (nodes <= cells, edges <= 2 * cells
+// since each edge uses two of a node's four ports), so they can't overflow:
+// 10 + 16 + 2 + 5 bytes per cell, ~17 KB for 30x17. The list of cells to
+// re-trace after an addCell() is fixed-size; if it ever fills, the patch
+// can't be trusted and the whole graph is rebuilt instead.
+class RoadGraph {
+public:
+  static constexpr uint16_t NONE = 0xFFFF;
+
+  struct Node {
+    uint16_t cell;       // y * W + x
+    uint16_t edge[4];    // per direction E, S, W, N; NONE if no edge
+  };
+
+  struct Edge {
+    uint16_t a, b;       // node indices
+    uint8_t  da, db;     // direction the edge leaves a / arrives at b
+    uint16_t len;        // steps from a to b
+  };
+
+  RoadGraph() = default;
+  RoadGraph(const RoadGraph &) = delete;
+  RoadGraph &operator=(const RoadGraph &) = delete;
+
+  ~RoadGraph() {
+    if (nodes) free(nodes);
+    if (edges) free(edges);
+    if (nodeOf) free(nodeOf);
+  }
+
+  bool init(uint16_t w, uint16_t h) {
+    W = w; H = h;
+    uint32_t cells = (uint32_t)w * h;
+    nodes  = (Node*)malloc(cells * sizeof(Node));
+    edges  = (Edge*)malloc(2 * cells * sizeof(Edge));
+    nodeOf = (uint16_t*)malloc(cells * sizeof(uint16_t));
+    road.init(w, h);
+    parts.init(cells);
+    clear();
+    return valid();
+  }
+
+  void clear() {
+    road.clearAll();
+    parts.clear();
+    nodeCount = 0;
+    edgeCount = 0;
+    if (nodeOf) memset(nodeOf, 0xFF, (size_t)W * H * sizeof(uint16_t));
+  }
+
+  bool valid() const { return nodes && edges && nodeOf && road.valid() && parts.valid(); }
+  bool isRoad(uint16_t x, uint16_t y) const { return road.test(x, y); }
+  uint16_t width()  const { return W; }
+  uint16_t height() const { return H; }
+
+  // Mark (x, y) as road and patch the graph around it
+  void addCell(uint16_t x, uint16_t y) {
+    if (road.test(x, y)) return;
+    uint16_t p = y * W + x;
+
+    pendingCount = 0;
+    pendingOver = false;
+    pushPending(p);
+
+    // Drop everything the old topology had running through the neighbours
+    for (uint8_t d = 0; d < 4; d++) {
+      uint16_t q;
+      if (!neighbour(p, d, q) || !roadAt(q)) continue;
+      pushPending(q);
+      uint16_t n = nodeOf[q];
+      if (n != NONE) {
+        for (uint8_t k = 0; k < 4; k++) {
+          if (nodes[n].edge[k] != NONE) dropEdge(nodes[n].edge[k]);
+        }
+      } else {
+        uint16_t e = edgeThrough(q);
+        if (e != NONE) dropEdge(e);
+      }
+    }
+
+    road.set(x, y);
+    parts.add(p);
+    for (uint8_t d = 0; d < 4; d++) {
+      uint16_t q;
+      if (neighbour(p, d, q) && roadAt(q)) parts.unite(p, q);
+    }
+
+    // Degrees changed only for p and its neighbours
+    for (uint8_t d = 0; d <= 4; d++) {
+      uint16_t c = p;
+      if (d < 4 && (!neighbour(p, d, c) || !roadAt(c))) continue;
+      bool want = degree(c) != 2;
+      uint16_t n = nodeOf[c];
+      if (want && n == NONE) addNode(c);
+      else if (!want && n != NONE) removeNode(n);
+    }
+
+    if (pendingOver) {
+      rebuild();
+      rebuildCount++;
+      return;
+    }
+    for (uint8_t i = 0; i < pendingCount; i++) {
+      uint16_t n = nodeOf[pending[i]];
+      if (n != NONE) traceOpen(n);
+    }
+  }
+
+  // Batch extraction from the current road bitset
+  void rebuild() {
+    nodeCount = 0;
+    edgeCount = 0;
+    memset(nodeOf, 0xFF, (size_t)W * H * sizeof(uint16_t));
+    parts.clear();
+    road.forEachSet([&](uint16_t x, uint16_t y) {
+      uint16_t c = y * W + x;
+      if (degree(c) != 2) addNode(c);
+      // east and south neighbours are still to come; west and north are in
+      parts.add(c);
+      if (x > 0 && road.test(x - 1, y)) parts.unite(c, c - 1);
+      if (y > 0 && road.test(x, y - 1)) parts.unite(c, c - W);
+    });
+    for (uint16_t n = 0; n < nodeCount; n++) traceOpen(n);
+  }
+
+  // Calls fn(x, y) for every cell of edge e, from its a end to its b end
+  template <class Fn>
+  void forEachEdgeCell(uint16_t e, Fn fn) const {
+    const Edge &ed = edges[e];
+    uint16_t c = nodes[ed.a].cell;
+    uint8_t dir = ed.da;
+    fn(c % W, c / W);
+    for (uint16_t i = 0; i < ed.len; i++) {
+      neighbour(c, dir, c);
+      fn(c % W, c / W);
+      if (i + 1 < ed.len) dir = nextDir(c, dir ^ 2);
+    }
+  }
+
+  // Separate road networks and the cell count of the biggest, O(1)
+  uint16_t componentCount() const { return parts.count(); }
+  uint16_t largestComponent() const { return parts.largest(); }
+
+  // True if both cells are road and joined by road (path compression makes
+  // this non-const)
+  bool connected(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    uint16_t a = y0 * W + x0, b = y1 * W + x1;
+    return parts.contains(a) && parts.contains(b) && parts.find(a) == parts.find(b);
+  }
+
+  // addCell() calls that fell back to rebuild() since init()
+  uint32_t fallbackRebuilds() const { return rebuildCount; }
+
+  uint16_t nodeTotal() const { return nodeCount; }
+  uint16_t edgeTotal() const { return edgeCount; }
+  const Node &node(uint16_t i) const { return nodes[i]; }
+  const Edge &edge(uint16_t i) const { return edges[i]; }
+
+private:
+  static constexpr uint8_t MAX_PENDING = 48;
+
+  bool roadAt(uint16_t c) const { return road.test(c % W, c / W); }
+
+  bool neighbour(uint16_t c, uint8_t d, uint16_t &out) const {
+    uint16_t x = c % W, y = c / W;
+    switch (d) {
+      case 0: if (x + 1 >= W) return false; out = c + 1; return true;
+      case 1: if (y + 1 >= H) return false; out = c + W; return true;
+      case 2: if (x == 0)     return false; out = c - 1; return true;
+      default: if (y == 0)    return false; out = c - W; return true;
+    }
+  }
+
+  uint8_t degree(uint16_t c) const {
+    uint8_t n = 0;
+    for (uint8_t d = 0; d < 4; d++) {
+      uint16_t q;
+      if (neighbour(c, d, q) && roadAt(q)) n++;
+    }
+    return n;
+  }
+
+  // On a chain cell, the road direction other than `from`
+  uint8_t nextDir(uint16_t c, uint8_t from) const {
+    for (uint8_t d = 0; d < 4; d++) {
+      uint16_t q;
+      if (d != from && neighbour(c, d, q) && roadAt(q)) return d;
+    }
+    return from;
+  }
+
+  void pushPending(uint16_t c) {
+    if (pendingCount < MAX_PENDING) pending[pendingCount++] = c;
+    else pendingOver = true;
+  }
+
+  // --- nodes: dense array plus a cell -> index map ---
+
+  void addNode(uint16_t c) {
+    uint16_t n = nodeCount++;
+    nodes[n].cell = c;
+    for (uint8_t d = 0; d < 4; d++) nodes[n].edge[d] = NONE;
+    nodeOf[c] = n;
+  }
+
+  // Node must have no edges left. The last node moves into the hole.
+  void removeNode(uint16_t n) {
+    nodeOf[nodes[n].cell] = NONE;
+    uint16_t last = --nodeCount;
+    if (n == last) return;
+    nodes[n] = nodes[last];
+    nodeOf[nodes[n].cell] = n;
+    for (uint8_t d = 0; d < 4; d++) {
+      uint16_t e = nodes[n].edge[d];
+      if (e == NONE) continue;
+      if (edges[e].a == last && edges[e].da == d) edges[e].a = n;
+      if (edges[e].b == last && edges[e].db == d) edges[e].b = n;
+    }
+  }
+
+  // --- edges ---
+
+  // The edge whose chain contains chain cell c, found by walking to an end
+  uint16_t edgeThrough(uint16_t c) const {
+    uint8_t dir = nextDir(c, 0xFF);
+    uint16_t cur = c;
+    for (uint32_t guard = 0; guard < (uint32_t)W * H; guard++) {
+      uint16_t nxt;
+      if (!neighbour(cur, dir, nxt)) return NONE;
+      uint8_t back = dir ^ 2;
+      uint16_t n = nodeOf[nxt];
+      if (n != NONE) return nodes[n].edge[back];
+      if (nxt == c) return NONE;     // ring with no nodes
+      cur = nxt;
+      dir = nextDir(cur, back);
+    }
+    return NONE;
+  }
+
+  void dropEdge(uint16_t e) {
+    Edge &ed = edges[e];
+    nodes[ed.a].edge[ed.da] = NONE;
+    nodes[ed.b].edge[ed.db] = NONE;
+    pushPending(nodes[ed.a].cell);
+    pushPending(nodes[ed.b].cell);
+
+    uint16_t last = --edgeCount;
+    if (e == last) return;
+    edges[e] = edges[last];
+    nodes[edges[e].a].edge[edges[e].da] = e;
+    nodes[edges[e].b].edge[edges[e].db] = e;
+  }
+
+  // Trace every road direction of node n that has no edge yet
+  void traceOpen(uint16_t n) {
+    for (uint8_t d = 0; d < 4; d++) {
+      uint16_t q;
+      if (nodes[n].edge[d] != NONE || !neighbour(nodes[n].cell, d, q) || !roadAt(q)) continue;
+
+      uint16_t cur = nodes[n].cell;
+      uint8_t dir = d;
+      uint16_t len = 0;
+      uint16_t m = NONE;
+      for (uint32_t guard = 0; guard < (uint32_t)W * H && m == NONE; guard++) {
+        neighbour(cur, dir, cur);
+        len++;
+        m = nodeOf[cur];
+        if (m == NONE) dir = nextDir(cur, dir ^ 2);
+      }
+      if (m == NONE) continue;
+
+      uint16_t e = edgeCount++;
+      edges[e] = Edge{n, m, d, (uint8_t)(dir ^ 2), len};
+      nodes[n].edge[d] = e;
+      nodes[m].edge[dir ^ 2] = e;
+    }
+  }
+
+  uint16_t W = 0, H = 0;
+  BitPlane road;
+  UnionFind parts;               // connected components of road cells
+
+  Node *nodes = nullptr;
+  Edge *edges = nullptr;
+  uint16_t *nodeOf = nullptr;
+  uint16_t nodeCount = 0;
+  uint16_t edgeCount = 0;
+
+  uint16_t pending[MAX_PENDING];
+  uint8_t pendingCount = 0;
+  bool pendingOver = false;      // pending[] filled up during this addCell()
+  uint32_t rebuildCount = 0;
+};
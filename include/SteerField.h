@@ -0,0 +1,132 @@
+#pragma once
+#include <Arduino.h>
+#include "BitPlane.h"
+
+// Coarse steering field for agents: one cell per 8x8 pixels (30x17 on the
+// T-Display), each with a potential and the direction that climbs it.
+//
+// A cell's own pull comes from the pixels under it: thinly lit cells
+// attract, dense ones and water push away, so agents head for the edge of
+// the city rather than piling into downtown. Attraction spreads to
+// neighbours, FALLOFF less per cell, so agents out in the dark still feel
+// the nearest district. Repulsive cells keep their own (negative) value.
+//
+// update() refreshes a fixed number of cells round-robin, each reading its
+// 64 pixels and its 8 neighbours, so the cost per call is bounded however
+// much the city changed; a full sweep takes cols * rows / n calls. Agents
+// read dirAt(), a single byte lookup: an 8-bit heading, or NONE where the
+// field is flat.
+class SteerField {
+public:
+  static constexpr uint8_t CELL_SHIFT = 3;
+  static constexpr uint8_t NONE = 0xFF;
+
+  SteerField() = default;
+  SteerField(const SteerField &) = delete;
+  SteerField &operator=(const SteerField &) = delete;
+
+  ~SteerField() {
+    if (pot) free(pot);
+    if (dir) free(dir);
+  }
+
+  bool init(uint16_t w, uint16_t h) {
+    W = w; H = h;
+    cols = (w + (1 << CELL_SHIFT) - 1) >> CELL_SHIFT;
+    rows = (h + (1 << CELL_SHIFT) - 1) >> CELL_SHIFT;
+    pot = (int8_t*)malloc((size_t)cols * rows);
+    dir = (uint8_t*)malloc((size_t)cols * rows);
+    clear();
+    return valid();
+  }
+
+  bool valid() const { return pot && dir; }
+
+  void clear() {
+    if (!valid()) return;
+    memset(pot, 0, (size_t)cols * rows);
+    memset(dir, NONE, (size_t)cols * rows);
+    cursor = 0;
+  }
+
+  // Refresh the next n cells from the grid (W*H bytes) and blocked cells
+  // (may be nullptr)
+  void update(const uint8_t *grid, const BitPlane *blocked, uint16_t n) {
+    const uint16_t cells = (uint16_t)cols * rows;
+    for (uint16_t i = 0; i < n; i++) {
+      uint8_t cx = cursor % cols, cy = cursor / cols;
+      refresh(grid, blocked, cx, cy);
+      cursor = (cursor + 1) % cells;
+    }
+  }
+
+  uint8_t dirAt(int16_t x, int16_t y) const {
+    return dir[(y >> CELL_SHIFT) * cols + (x >> CELL_SHIFT)];
+  }
+
+  int8_t potentialAt(int16_t x, int16_t y) const {
+    return pot[(y >> CELL_SHIFT) * cols + (x >> CELL_SHIFT)];
+  }
+
+  uint8_t cellCols() const { return cols; }
+  uint8_t cellRows() const { return rows; }
+
+private:
+  static constexpr uint8_t DENSE = 64;        // mean intensity that repels
+  static constexpr int8_t  FALLOFF = 6;       // attraction lost per cell
+  static constexpr int8_t  WATER = -100;
+
+  void refresh(const uint8_t *grid, const BitPlane *blocked, uint8_t cx, uint8_t cy) {
+    int16_t x0 = cx << CELL_SHIFT, y0 = cy << CELL_SHIFT;
+    int16_t x1 = min<int16_t>(W, x0 + (1 << CELL_SHIFT));
+    int16_t y1 = min<int16_t>(H, y0 + (1 << CELL_SHIFT));
+
+    uint16_t sum = 0, wet = 0;
+    for (int16_t y = y0; y < y1; y++) {
+      const uint8_t *g = grid + (uint32_t)y * W;
+      for (int16_t x = x0; x < x1; x++) sum += g[x];
+      // cells are 8-aligned, so the cell's row is one byte of a mask word
+      if (blocked) wet += __builtin_popcount((blocked->row(y)[x0 >> 5] >> (x0 & 31)) & 0xFF);
+    }
+    uint16_t area = (uint16_t)(x1 - x0) * (y1 - y0);
+    uint8_t mean = sum / area;
+
+    int8_t p;
+    if (wet * 2 >= area) p = WATER;
+    else if (mean >= DENSE) p = -(int8_t)min<int16_t>(100, (mean - DENSE) * 2);
+    else {
+      p = mean / 2;
+      int8_t best = bestNeighbour(cx, cy, nullptr);
+      if (best - FALLOFF > p) p = best - FALLOFF;
+    }
+    pot[cy * cols + cx] = p;
+
+    uint8_t heading = NONE;
+    int8_t best = bestNeighbour(cx, cy, &heading);
+    dir[cy * cols + cx] = best > p ? heading : NONE;
+  }
+
+  // Highest potential among the 8 neighbours, and the heading toward it
+  int8_t bestNeighbour(uint8_t cx, uint8_t cy, uint8_t *heading) const {
+    // E, SE, S, SW, W, NW, N, NE: heading = index * 32
+    static constexpr int8_t DX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+    static constexpr int8_t DY[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    int8_t best = INT8_MIN;
+    for (uint8_t k = 0; k < 8; k++) {
+      int16_t x = cx + DX[k], y = cy + DY[k];
+      if (x < 0 || y < 0 || x >= cols || y >= rows) continue;
+      int8_t v = pot[y * cols + x];
+      if (v > best) {
+        best = v;
+        if (heading) *heading = k * 32;
+      }
+    }
+    return best;
+  }
+
+  uint16_t W = 0, H = 0;
+  uint8_t cols = 0, rows = 0;
+  int8_t  *pot = nullptr;
+  uint8_t *dir = nullptr;
+  uint16_t cursor = 0;
+};
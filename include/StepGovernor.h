@@ -0,0 +1,65 @@
+#pragma once
+#include <Arduino.h>
+
+// Fixed-timestep sim clock: the sim advances one step per 1/rate seconds
+// of wall clock, however fast or slow frames are drawn, so a speed level
+// means the same growth rate on any board and at any render rate.
+//
+// Wall-clock time piles up in an accumulator and plan() pays it out in
+// whole steps. A frame never spends more than the budget it is given
+// stepping (the caller scales it with the frame period, so slower frames
+// carry bigger batches), judged by the measured cost of a step (record()
+// folds each frame's stepping time into a running average, 1/8 weight,
+// microseconds in Q4). Whatever doesn't fit is kept and caught up over
+// the next frames, in batches bounded the same way. The accumulator is
+// clamped to MAX_BEHIND_US, so after a long stall, or at a rate the CPU
+// can't sustain, the sim falls behind instead of piling up work it can
+// never finish.
+class StepGovernor {
+public:
+  static constexpr uint32_t MAX_BEHIND_US = 500000; // debt beyond this is dropped
+
+  void setRate(uint16_t stepsPerSec) {
+    period = stepsPerSec ? 1000000UL / stepsPerSec : 0;
+    rate = stepsPerSec;
+    acc = 0;
+  }
+
+  // Steps to run this frame, spending at most budgetUs on them
+  uint16_t plan(uint32_t nowUs, uint32_t budgetUs) {
+    uint32_t dt = started ? nowUs - lastUs : 0;
+    started = true;
+    lastUs = nowUs;
+    if (!period) return 0;
+
+    acc = min<uint32_t>(acc + min<uint32_t>(dt, MAX_BEHIND_US), MAX_BEHIND_US);
+    uint32_t steps = acc / period;
+
+    uint32_t fit = (budgetUs << 4) / (costQ4 ? costQ4 : 1);
+    if (!fit) fit = 1;
+    if (steps > fit) steps = fit;
+    acc -= steps * period;
+    return (uint16_t)steps;
+  }
+
+  // How long the planned steps actually took
+  void record(uint16_t steps, uint32_t us) {
+    if (!steps) return;
+    int32_t sample = (int32_t)min<uint32_t>((us << 4) / steps, 0xFFFFFF);
+    costQ4 += (sample - costQ4) / 8;
+    if (costQ4 < 1) costQ4 = 1;
+  }
+
+  uint16_t targetRate() const { return rate; }
+  uint32_t stepCostUs() const { return (uint32_t)costQ4 >> 4; }
+  // Wall-clock time the sim is behind, us
+  uint32_t behindUs() const { return acc; }
+
+private:
+  uint16_t rate = 0;
+  uint32_t period = 0;                         // us per step
+  uint32_t acc = 0;                            // us owed
+  int32_t  costQ4 = 50 << 4;                   // first guess: 50 us a step
+  uint32_t lastUs = 0;
+  bool started = false;
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <Arduino.h>
+#include "Palette.h"
+
+// Visual styles: each one is a 256-entry intensity -> RGB565 ramp generated
+// at compile time. Picking a style is just picking a table pointer; the
+// conversion loop never changes.
+
+enum Style : uint8_t {
+  STYLE_SATELLITE = 0,
+  STYLE_THERMAL,
+  STYLE_BLUEPRINT,
+  STYLE_SYNTHWAVE,
+  STYLE_AMBER,
+  STYLE_COUNT
+};
+
+struct PaletteTable {
+  uint16_t c[256];
+};
+
+template <class Fn>
+constexpr PaletteTable makePalette(Fn fn) {
+  PaletteTable t{};
+  for (uint16_t v = 0; v < 256; v++) t.c[v] = fn((uint8_t)v);
+  return t;
+}
+
+struct RampStop {
+  uint8_t v, r, g, b;
+};
+
+// Piecewise-linear ramp through stops (stops sorted by v, first at 0, last at 255)
+template <size_t N>
+constexpr uint16_t rampColor(const RampStop (&stops)[N], uint8_t v) {
+  for (size_t i = 1; i < N; i++) {
+    if (v <= stops[i].v) {
+      const RampStop &a = stops[i - 1];
+      const RampStop &b = stops[i];
+      int span = b.v - a.v;
+      int t = span ? (v - a.v) : 0;
+      if (!span) span = 1;
+      return rgb565((uint8_t)(a.r + (b.r - a.r) * t / span),
+                    (uint8_t)(a.g + (b.g - a.g) * t / span),
+                    (uint8_t)(a.b + (b.b - a.b) * t / span));
+    }
+  }
+  return rgb565(stops[N - 1].r, stops[N - 1].g, stops[N - 1].b);
+}
+
+namespace styles {
+
+// Original "night satellite" ramp: dark blues for low, warm whites for high
+constexpr uint16_t satellite(uint8_t v) {
+  if (v < 10) return rgb565(0, 0, 6);
+  if (v < 80) return rgb565(0, 4 + v / 10, 10 + v / 3);
+  uint8_t x = v - 80;  // 0..175
+  return rgb565(30 + x, 22 + (x * 7) / 10, 10 + (x * 2) / 10);
+}
+
+constexpr RampStop THERMAL[] = {
+  {0, 0, 0, 8}, {40, 40, 0, 90}, {90, 160, 0, 120},
+  {150, 240, 60, 0}, {210, 255, 200, 0}, {255, 255, 255, 230}
+};
+
+constexpr RampStop BLUEPRINT[] = {
+  {0, 0, 16, 48}, {10, 0, 24, 72}, {80, 40, 110, 200},
+  {180, 160, 220, 255}, {255, 240, 250, 255}
+};
+
+// Matches showSplash(): purple dusk, hot pink roads, cyan lights
+constexpr RampStop SYNTHWAVE[] = {
+  {0, 6, 0, 14}, {10, 20, 0, 40}, {80, 248, 0, 248},
+  {160, 120, 80, 255}, {220, 0, 255, 255}, {255, 220, 255, 255}
+};
+
+constexpr RampStop AMBER[] = {
+  {0, 0, 0, 0}, {10, 12, 6, 0}, {80, 120, 70, 0},
+  {200, 255, 176, 0}, {255, 255, 230, 140}
+};
+
+constexpr uint16_t thermal(uint8_t v)   { return rampColor(THERMAL, v); }
+constexpr uint16_t blueprint(uint8_t v) { return rampColor(BLUEPRINT, v); }
+constexpr uint16_t synthwave(uint8_t v) { return rampColor(SYNTHWAVE, v); }
+constexpr uint16_t amber(uint8_t v)     { return rampColor(AMBER, v); }
+
+constexpr PaletteTable PAL_SATELLITE = makePalette(satellite);
+constexpr PaletteTable PAL_THERMAL   = makePalette(thermal);
+constexpr PaletteTable PAL_BLUEPRINT = makePalette(blueprint);
+constexpr PaletteTable PAL_SYNTHWAVE = makePalette(synthwave);
+constexpr PaletteTable PAL_AMBER     = makePalette(amber);
+
+}  // namespace styles
+
+static const uint16_t *const STYLE_TABLES[STYLE_COUNT] = {
+  styles::PAL_SATELLITE.c,
+  styles::PAL_THERMAL.c,
+  styles::PAL_BLUEPRINT.c,
+  styles::PAL_SYNTHWAVE.c,
+  styles::PAL_AMBER.c,
+};
+
+static const char *const STYLE_NAMES[STYLE_COUNT] = {
+  "SATELLITE", "THERMAL", "BLUEPRINT", "SYNTHWAVE", "AMBER"
+};
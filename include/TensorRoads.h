@@ -0,0 +1,217 @@
+#pragma once
+#include <Arduino.h>
+#include "GridEngine.h"
+#include "BitPlane.h"
+#include "FixedMath.h"
+
+// Planned-city road generator: roads follow a coarse tensor field instead
+// of turning at random, so they come out as street grids and as radial
+// avenues with ring roads around each centre.
+//
+// The field holds one major direction per 8x8-pixel cell (angle mod 128,
+// since a road runs both ways). It blends a global grid orientation with a
+// radial pattern around every centre, weighted by closeness; the blend is
+// done on doubled angles so opposite directions reinforce.
+//
+// Roads are traced L-system style. A tracer walks one pixel per unit of
+// work along the major (or minor) direction, leaving road, and every so
+// often queues two perpendicular children of the other family one level
+// deeper. A road ends when it meets another road, leaves the screen or
+// runs out of length. Tracers run round-robin from a small active set fed
+// by a fixed-size ring queue (full = the branch is dropped), and step()
+// does a fixed amount of tracing, so memory is bounded and the city
+// animates at an even pace. When everything has been traced, a new centre
+// is founded and the field is re-blended for the roads still to come;
+// after MAX_CENTERS the city is complete and the engine reports
+// finished(), so a new one starts instead of a frozen screen.
+class TensorRoads : public GridEngine {
+public:
+  TensorRoads(uint16_t w, uint16_t h)
+  : GridEngine(w, h), CW((w + CELL - 1) >> CELL_SHIFT), CH((h + CELL - 1) >> CELL_SHIFT) {
+    roads.init(w, h);
+    field = (uint8_t*)malloc((size_t)CW * CH);
+  }
+
+  ~TensorRoads() {
+    if (field) free(field);
+  }
+
+  bool valid() const { return GridEngine::valid() && roads.valid() && field; }
+
+  void reset(uint32_t seed) {
+    if (!valid()) return;
+    seedRandom(seed);
+    clearGrid();
+    roads.clearAll();
+    activeCount = 0;
+    queueHead = queueCount = 0;
+    centerCount = 0;
+    gridAngle = rand32() & 127;
+    found(W / 2, H / 2);
+  }
+
+  void step() {
+    if (done) return;
+    for (uint8_t n = 0; n < WORK_PER_STEP; n++) {
+      while (activeCount < MAX_ACTIVE && queueCount) {
+        active[activeCount++] = queue[queueHead];
+        queueHead = (queueHead + 1) % QUEUE_CAP;
+        queueCount--;
+      }
+      if (!activeCount) {
+        if (centerCount >= MAX_CENTERS) {           // city complete
+          done = true;
+          return;
+        }
+        foundNext();
+        continue;
+      }
+      uint8_t i = cursor++ % activeCount;
+      if (!advance(active[i])) active[i] = active[--activeCount];
+    }
+  }
+
+private:
+  struct Tracer {
+    int32_t  x, y;         // 16.16 px
+    uint8_t  heading;
+    uint8_t  minor;        // 0 = along the major direction, 1 = across it
+    uint8_t  depth;
+    uint8_t  sinceBranch;
+    uint16_t left;         // px still to go
+    uint16_t walked;
+  };
+
+  static constexpr uint8_t  CELL_SHIFT = 3;         // field cell = 8x8 px
+  static constexpr uint8_t  CELL = 1 << CELL_SHIFT;
+  static constexpr uint8_t  MAX_ACTIVE = 8;
+  static constexpr uint8_t  QUEUE_CAP = 64;
+  static constexpr uint8_t  WORK_PER_STEP = 4;      // px traced per step
+  static constexpr uint8_t  MAX_CENTERS = 8;
+  static constexpr uint8_t  MAX_DEPTH = 3;
+  static constexpr uint16_t LENGTH[MAX_DEPTH + 1] = {80, 50, 30, 20};
+  static constexpr uint8_t  SPACING[MAX_DEPTH + 1] = {22, 16, 12, 10};
+  static constexpr uint8_t  ROAD[MAX_DEPTH + 1] = {90, 70, 55, 45};
+  static constexpr uint8_t  JUNCTION = 40;          // extra light where roads meet
+  static constexpr uint8_t  MIN_WALK = 3;           // ignore the road we left
+  static constexpr int32_t  GRID_WEIGHT = 48;
+  static constexpr int32_t  RADIAL_R2 = 45 * 45;    // radial pull falls off past ~45 px
+
+  // One pixel of road; false when this tracer is done
+  bool advance(Tracer &t) {
+    int16_t cx = (t.x + 0x8000) >> 16, cy = (t.y + 0x8000) >> 16;
+    t.heading = steer(t.heading, direction(cx, cy, t.minor));
+
+    int32_t nx = t.x + (int32_t)icos8(t.heading) * 256;
+    int32_t ny = t.y + (int32_t)isin8(t.heading) * 256;
+    int16_t px = (nx + 0x8000) >> 16, py = (ny + 0x8000) >> 16;
+    if (px < 1 || py < 1 || px >= (int16_t)W - 1 || py >= (int16_t)H - 1) return false;
+
+    // meeting another road (diagonal steps check both corners so a line
+    // can't slip through another one)
+    if (t.walked >= MIN_WALK && (px != cx || py != cy) &&
+        (roads.test(px, py) || (px != cx && py != cy && (roads.test(px, cy) || roads.test(cx, py))))) {
+      addIntensity(px, py, JUNCTION);
+      return false;
+    }
+
+    t.x = nx;
+    t.y = ny;
+    t.walked++;
+    if (px != cx || py != cy) {
+      roads.set(px, py);
+      addIntensity(px, py, ROAD[t.depth]);
+    }
+
+    if (++t.sinceBranch >= SPACING[t.depth] && t.depth < MAX_DEPTH) {
+      t.sinceBranch = rand32() % 4;
+      spawn(t.x, t.y, t.heading + 64, !t.minor, t.depth + 1);
+      spawn(t.x, t.y, t.heading - 64, !t.minor, t.depth + 1);
+    }
+    return --t.left > 0;
+  }
+
+  void spawn(int32_t x, int32_t y, uint8_t heading, uint8_t minor, uint8_t depth) {
+    if (queueCount >= QUEUE_CAP) return;
+    Tracer &t = queue[(queueHead + queueCount++) % QUEUE_CAP];
+    t = Tracer{x, y, heading, minor, depth, 0,
+               (uint16_t)(LENGTH[depth] / 2 + rand32() % LENGTH[depth]), 0};
+  }
+
+  // Field direction at a pixel for the family, as a full 0..255 angle
+  uint8_t direction(int16_t x, int16_t y, uint8_t minor) const {
+    return field[(y >> CELL_SHIFT) * CW + (x >> CELL_SHIFT)] + (minor ? 64 : 0);
+  }
+
+  // Turn halfway toward whichever way along the field is nearer ahead
+  static uint8_t steer(uint8_t heading, uint8_t dir) {
+    int8_t d = (int8_t)(uint8_t)(dir - heading);
+    if (d > 64 || d < -64) d = (int8_t)(uint8_t)(d + 128);
+    return heading + d / 2;
+  }
+
+  // Blend of the grid orientation and radial patterns around centres
+  void blendField() {
+    for (uint16_t cy = 0; cy < CH; cy++) {
+      for (uint16_t cx = 0; cx < CW; cx++) {
+        int16_t px = cx * CELL + CELL / 2, py = cy * CELL + CELL / 2;
+        int32_t c = GRID_WEIGHT * icos8(gridAngle * 2);
+        int32_t s = GRID_WEIGHT * isin8(gridAngle * 2);
+        for (uint8_t k = 0; k < centerCount; k++) {
+          int32_t dx = px - centers[k].x, dy = py - centers[k].y;
+          int32_t w = 256 * RADIAL_R2 / (RADIAL_R2 + dx * dx + dy * dy);
+          uint8_t a = iatan2(dy, dx) * 2;
+          c += w * icos8(a);
+          s += w * isin8(a);
+        }
+        field[cy * CW + cx] = (iatan2(s, c) >> 1) & 127;
+      }
+    }
+  }
+
+  // New centre: plaza glow, re-blended field, avenues heading out
+  void found(int16_t x, int16_t y) {
+    centers[centerCount++] = Center{x, y};
+    districts.addSite(x, y);
+    blendField();
+    bloom(x, y, 7, 140);
+    uint8_t rays = 4 + rand32() % 3;
+    uint8_t base = rand32();
+    for (uint8_t i = 0; i < rays; i++) {
+      spawn((int32_t)x << 16, (int32_t)y << 16, base + i * 256 / rays, 0, 0);
+    }
+  }
+
+  // Next centre out in the open, as far from the others as we can find
+  void foundNext() {
+    int16_t bestX = W / 2, bestY = H / 2;
+    int32_t best = -1;
+    for (uint8_t tries = 0; tries < 16; tries++) {
+      int16_t x = 8 + rand32() % (W - 16);
+      int16_t y = 8 + rand32() % (H - 16);
+      int32_t nearest = INT32_MAX;
+      for (uint8_t k = 0; k < centerCount; k++) {
+        int32_t dx = x - centers[k].x, dy = y - centers[k].y;
+        nearest = min(nearest, dx * dx + dy * dy);
+      }
+      int32_t score = nearest - (roads.test(x, y) ? 400 : 0);
+      if (score > best) { best = score; bestX = x; bestY = y; }
+    }
+    found(bestX, bestY);
+  }
+
+  struct Center { int16_t x, y; };
+
+  const uint16_t CW, CH;
+  BitPlane roads;                // traced road pixels
+  uint8_t *field = nullptr;      // major direction per cell, 0..127
+  uint8_t gridAngle = 0;
+  Center centers[MAX_CENTERS];
+  uint8_t centerCount = 0;
+
+  Tracer active[MAX_ACTIVE];
+  uint8_t activeCount = 0;
+  uint8_t cursor = 0;
+  Tracer queue[QUEUE_CAP];       // ring buffer of tracers still to start
+  uint8_t queueHead = 0, queueCount = 0;
+};
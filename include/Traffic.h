@@ -0,0 +1,176 @@
+#pragma once
+#include <Arduino.h>
+#include "Palette.h"
+
+// Traffic overlay: a pool of single-pixel "cars" that drive along lit road
+// cells. They live on top of the converted frame only: each car remembers
+// the sprite pixel it covered (save-under) and puts it back before moving,
+// so the sim grid is never touched.
+//
+// Storage is SoA with 8.8 fixed-point positions; a frame is
+// erase() -> update() -> [convert dirty tiles] -> draw(), and the pixels
+// changed by erase/draw are listed in touched() for pushing over SPI.
+// Positions are grid pixels; sprite pixels are those plus setOffset().
+class TrafficOverlay {
+public:
+  static constexpr uint16_t MAX_CARS = 320;
+  static constexpr uint8_t  ROAD_MIN = 30;       // cell counts as road from here
+  static constexpr uint8_t  ROAD_MAX = 250;      // saturated blobs aren't roads
+
+  void init(uint16_t w, uint16_t h) {
+    W = w; H = h;
+    count = 0;
+    resetTouched();
+  }
+
+  void clear() {
+    count = 0;
+    resetTouched();
+  }
+
+  void setEnabled(bool on) { enabled = on; }
+  bool isEnabled() const { return enabled; }
+  uint16_t size() const { return count; }
+
+  // Put back every pixel the cars covered last frame
+  void erase(uint16_t *dst) {
+    resetTouched();
+    for (uint16_t i = 0; i < count; i++) {
+      if (at[i] == NONE) continue;
+      dst[at[i]] = under[i];
+      touch(at[i]);
+      at[i] = NONE;
+    }
+  }
+
+  // Advance cars along bright cells; spawn a few new ones if below target
+  void update(const uint8_t *grid) {
+    if (!enabled) { count = 0; return; }
+
+    for (uint16_t i = 0; i < count; ) {
+      uint8_t ox = px[i] >> 8, oy = py[i] >> 8;
+      uint16_t nx16 = px[i] + DX[dir[i]] * spd[i];
+      uint16_t ny16 = py[i] + DY[dir[i]] * spd[i];
+      uint8_t nx = nx16 >> 8, ny = ny16 >> 8;
+
+      if ((nx != ox || ny != oy) && !isRoad(grid, nx, ny)) {
+        // Dead end ahead: take the brighter side road, else U-turn, else park
+        uint8_t best = 0xFF, bestV = 0;
+        static const uint8_t TRY[3] = {1, 3, 2};   // right, left, back
+        for (uint8_t t = 0; t < 3; t++) {
+          uint8_t d = (dir[i] + TRY[t]) & 3;
+          int16_t cx = ox + DX[d], cy = oy + DY[d];
+          if (!inside(cx, cy)) continue;
+          uint8_t v = grid[cy * W + cx];
+          if (v >= ROAD_MIN && v <= ROAD_MAX && v > bestV) { bestV = v; best = d; }
+        }
+        if (best == 0xFF) { kill(i); continue; }
+        dir[i] = best;
+        px[i] = ((uint16_t)ox << 8) | 0x80;
+        py[i] = ((uint16_t)oy << 8) | 0x80;
+      } else {
+        px[i] = nx16;
+        py[i] = ny16;
+      }
+      i++;
+    }
+
+    // Top up gradually so traffic grows with the road network
+    for (uint8_t tries = 0; tries < SPAWN_TRIES && count < MAX_CARS; tries++) {
+      uint8_t x = 1 + esp_random() % (W - 2);
+      uint8_t y = 1 + esp_random() % (H - 2);
+      if (!isRoad(grid, x, y)) continue;
+      px[count]  = ((uint16_t)x << 8) | 0x80;
+      py[count]  = ((uint16_t)y << 8) | 0x80;
+      dir[count] = esp_random() & 3;
+      spd[count] = 40 + esp_random() % 90;          // ~0.15..0.5 px/frame
+      col[count] = (esp_random() % 3) ? HEADLIGHT : TAILLIGHT;
+      at[count]  = NONE;
+      count++;
+    }
+  }
+
+  // Cars are drawn at grid position + (dx, dy), to follow a shifted picture
+  void setOffset(int8_t dx, int8_t dy) { offX = dx; offY = dy; }
+
+  // Save what's under each car, then paint it
+  void draw(uint16_t *dst) {
+    for (uint16_t i = 0; i < count; i++) {
+      int16_t x = (px[i] >> 8) + offX, y = (py[i] >> 8) + offY;
+      if (!inside(x, y)) continue;
+      uint16_t idx = (uint16_t)y * W + x;
+      under[i] = dst[idx];
+      dst[idx] = col[i];
+      at[i] = idx;
+      touch(idx);
+    }
+  }
+
+  // Pixel indices changed by the last erase()/draw() pair, each listed
+  // once (a car that stays on its pixel, or two cars sharing one, would
+  // otherwise list it twice)
+  const uint16_t *touchedPixels() const { return touched; }
+  uint16_t touchedSize() const { return touchedCount; }
+
+private:
+  static constexpr uint16_t NONE = 0xFFFF;
+  static constexpr uint8_t  SPAWN_TRIES = 4;
+  static constexpr uint8_t  TOUCH_BITS = 10;
+  static constexpr uint16_t TOUCH_SLOTS = 1 << TOUCH_BITS;
+  static constexpr uint16_t HEADLIGHT = swap565(rgb565(255, 250, 220));
+  static constexpr uint16_t TAILLIGHT = swap565(rgb565(255, 40, 20));
+  static constexpr int8_t DX[4] = {1, 0, -1, 0};
+  static constexpr int8_t DY[4] = {0, 1, 0, -1};
+
+  // List a pixel unless it's already listed this frame: open addressing
+  // on the index, with TOUCH_SLOTS well above the 2 * MAX_CARS entries
+  void touch(uint16_t idx) {
+    uint16_t h = (uint16_t)(idx * 40503u) >> (16 - TOUCH_BITS);
+    while (touchSet[h] != NONE) {
+      if (touchSet[h] == idx) return;
+      h = (h + 1) & (TOUCH_SLOTS - 1);
+    }
+    touchSet[h] = idx;
+    touched[touchedCount++] = idx;
+  }
+
+  void resetTouched() {
+    touchedCount = 0;
+    memset(touchSet, 0xFF, sizeof(touchSet));
+  }
+
+  bool inside(int16_t x, int16_t y) const {
+    return x >= 0 && y >= 0 && x < (int16_t)W && y < (int16_t)H;
+  }
+
+  bool isRoad(const uint8_t *grid, int16_t x, int16_t y) const {
+    if (!inside(x, y)) return false;
+    uint8_t v = grid[y * W + x];
+    return v >= ROAD_MIN && v <= ROAD_MAX;
+  }
+
+  // Swap-remove; the car was already erased this frame
+  void kill(uint16_t i) {
+    count--;
+    px[i] = px[count];  py[i] = py[count];
+    dir[i] = dir[count]; spd[i] = spd[count];
+    col[i] = col[count]; under[i] = under[count]; at[i] = at[count];
+  }
+
+  uint16_t W = 0, H = 0;
+  bool enabled = true;
+  uint16_t count = 0;
+  int8_t offX = 0, offY = 0;
+
+  // SoA car state
+  uint16_t px[MAX_CARS], py[MAX_CARS];   // 8.8 fixed point
+  uint8_t  dir[MAX_CARS];                // 0..3: E, S, W, N
+  uint8_t  spd[MAX_CARS];                // Q8 pixels per frame
+  uint16_t col[MAX_CARS];                // byte-swapped RGB565
+  uint16_t under[MAX_CARS];              // saved sprite pixel
+  uint16_t at[MAX_CARS];                 // where it was drawn, or NONE
+
+  uint16_t touched[2 * MAX_CARS];
+  uint16_t touchedCount = 0;
+  uint16_t touchSet[TOUCH_SLOTS];        // pixels in touched[], or NONE
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <Arduino.h>
+
+// Disjoint sets over a fixed number of cells, grown one cell at a time.
+// Union by rank with path compression, so find() is effectively constant.
+// Only cells that have been add()ed belong to any set. The number of sets
+// and the size of the largest are kept as counters: merges only ever grow
+// a set, so the largest can't shrink until clear(). 5 bytes per cell.
+class UnionFind {
+public:
+  static constexpr uint16_t NONE = 0xFFFF;
+
+  UnionFind() = default;
+  UnionFind(const UnionFind &) = delete;
+  UnionFind &operator=(const UnionFind &) = delete;
+
+  ~UnionFind() {
+    if (parent) free(parent);
+    if (setSize) free(setSize);
+    if (rank) free(rank);
+  }
+
+  bool init(uint16_t cells) {
+    n = cells;
+    parent  = (uint16_t*)malloc((size_t)n * sizeof(uint16_t));
+    setSize = (uint16_t*)malloc((size_t)n * sizeof(uint16_t));
+    rank    = (uint8_t*)malloc(n);
+    clear();
+    return valid();
+  }
+
+  bool valid() const { return parent && setSize && rank; }
+
+  void clear() {
+    if (parent) memset(parent, 0xFF, (size_t)n * sizeof(uint16_t));
+    sets = 0;
+    biggest = 0;
+  }
+
+  bool contains(uint16_t c) const { return parent[c] != NONE; }
+
+  // c becomes a set of its own (no-op if it's already in one)
+  void add(uint16_t c) {
+    if (parent[c] != NONE) return;
+    parent[c] = c;
+    setSize[c] = 1;
+    rank[c] = 0;
+    sets++;
+    if (!biggest) biggest = 1;
+  }
+
+  // Root of c's set; c must have been added
+  uint16_t find(uint16_t c) {
+    uint16_t root = c;
+    while (parent[root] != root) root = parent[root];
+    while (parent[c] != root) {
+      uint16_t next = parent[c];
+      parent[c] = root;
+      c = next;
+    }
+    return root;
+  }
+
+  // Merge the sets of a and b; returns false if they were already one
+  bool unite(uint16_t a, uint16_t b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    if (rank[a] < rank[b]) { uint16_t t = a; a = b; b = t; }
+    parent[b] = a;
+    setSize[a] += setSize[b];
+    if (rank[a] == rank[b]) rank[a]++;
+    sets--;
+    if (setSize[a] > biggest) biggest = setSize[a];
+    return true;
+  }
+
+  uint16_t sizeOf(uint16_t c) { return setSize[find(c)]; }
+  uint16_t count() const { return sets; }
+  uint16_t largest() const { return biggest; }
+
+private:
+  uint16_t n = 0;
+  uint16_t *parent = nullptr;    // NONE = not added
+  uint16_t *setSize = nullptr;   // valid at roots
+  uint8_t  *rank = nullptr;      // valid at roots
+  uint16_t sets = 0;
+  uint16_t biggest = 0;
+};
@@ -0,0 +1,242 @@
+#pragma once
+#include <Arduino.h>
+#include "BitPlane.h"
+#include "LandUse.h"
+
+// Land-use zones grown as a cellular automaton next to the roads.
+//
+// Each zone class is a bitplane (1 bit per pixel), so one generation works
+// on 32 cells per word operation. The Moore neighbour count of a class is
+// summed bit-sliced: the 8 shifted neighbour words go through full/half
+// adders and come out as four bit-planes of the 0..8 count, then the rules
+// below are plain AND/OR on those bits. A generation is updated in place,
+// row by row, keeping old copies of the row above in two rolling buffers.
+//
+// Rules, per cell (n = neighbours of that class):
+//   empty and served:  industry if n >= 3, else commerce if n >= 3,
+//                      else housing if n >= 3
+//   housing:           commerce if n >= 5, else industry if n >= 5
+//   blocked (water):   always empty
+// "Served" cells are within SERVE_R px of a road. rule() is the same thing
+// for a single cell, which the byte-per-cell benchmark uses as reference.
+//
+// The planes are stored in 32-bit words, the ESP32's width. On 64-bit
+// little-endian hosts a generation reads them two words at a time instead
+// (64 cells per operation) when rows are a whole number of 64-bit words;
+// the bit order is the same, so the result is too.
+#ifndef ZONING_WIDE
+#if UINTPTR_MAX > 0xFFFFFFFFu && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define ZONING_WIDE 1
+#else
+#define ZONING_WIDE 0
+#endif
+#endif
+
+class Zoning {
+public:
+  // same numbering as LandClass, so zones can be rendered directly
+  enum Zone : uint8_t { ZONE_NONE = LAND_NONE, ZONE_RES = LAND_RES, ZONE_COM = LAND_COM,
+                       ZONE_IND = LAND_IND, ZONES = LAND_CLASSES };
+
+  Zoning() = default;
+  Zoning(const Zoning &) = delete;
+  Zoning &operator=(const Zoning &) = delete;
+
+  ~Zoning() {
+    if (save) free(save);
+  }
+
+  bool init(uint16_t w, uint16_t h) {
+    W = w; H = h;
+    for (uint8_t z = 0; z < CLASSES; z++) planes[z].init(w, h);
+    served.init(w, h);
+    stride = served.wordsPerRow();
+    // old rows y-1 and y of every class
+    save = (uint32_t*)malloc((size_t)2 * CLASSES * stride * sizeof(uint32_t));
+    return valid();
+  }
+
+  bool valid() const {
+    for (uint8_t z = 0; z < CLASSES; z++) if (!planes[z].valid()) return false;
+    return served.valid() && save;
+  }
+
+  void clear() {
+    for (uint8_t z = 0; z < CLASSES; z++) planes[z].clearAll();
+    served.clearAll();
+  }
+
+  // Road at a pixel: the square around it becomes buildable
+  void markRoad(int16_t x, int16_t y) {
+    int16_t y0 = max<int16_t>(0, y - SERVE_R), y1 = min<int16_t>(H - 1, y + SERVE_R);
+    for (int16_t yy = y0; yy <= y1; yy++) served.setSpan(yy, x - SERVE_R, x + SERVE_R);
+  }
+
+  // Square of one zone (r = 0 for a single cell), replacing whatever was there
+  void seed(int16_t x, int16_t y, uint8_t zone, uint8_t r) {
+    for (int16_t yy = y - r; yy <= y + r; yy++) {
+      if (yy < 0 || yy >= (int16_t)H) continue;
+      for (int16_t xx = x - r; xx <= x + r; xx++) {
+        if (xx < 0 || xx >= (int16_t)W) continue;
+        for (uint8_t z = 0; z < CLASSES; z++) planes[z].reset(xx, yy);
+        if (zone != ZONE_NONE) planes[zone - 1].set(xx, yy);
+      }
+    }
+  }
+
+  // One generation. Cells set in blocked (may be nullptr) are cleared and
+  // never zoned.
+  void step(const BitPlane *blocked) {
+#if ZONING_WIDE
+    if (!(stride & 1)) { stepWords<uint64_t>(blocked); return; }
+#endif
+    stepWords<uint32_t>(blocked);
+  }
+
+  // Single-cell version of step(), for reference
+  static uint8_t rule(uint8_t zone, uint8_t nRes, uint8_t nCom, uint8_t nInd,
+                      bool isServed, bool isBlocked) {
+    if (isBlocked) return ZONE_NONE;
+    if (zone == ZONE_NONE) {
+      if (!isServed) return ZONE_NONE;
+      if (nInd >= 3) return ZONE_IND;
+      if (nCom >= 3) return ZONE_COM;
+      if (nRes >= 3) return ZONE_RES;
+      return ZONE_NONE;
+    }
+    if (zone == ZONE_RES) {
+      if (nCom >= 5) return ZONE_COM;
+      if (nInd >= 5) return ZONE_IND;
+    }
+    return zone;
+  }
+
+  uint8_t at(uint16_t x, uint16_t y) const {
+    for (uint8_t z = 0; z < CLASSES; z++) if (planes[z].test(x, y)) return z + 1;
+    return ZONE_NONE;
+  }
+
+  const BitPlane &plane(uint8_t zone) const { return planes[zone - 1]; }
+  const BitPlane &servedPlane() const { return served; }
+  uint32_t count(uint8_t zone) const { return planes[zone - 1].count(); }
+
+private:
+  static constexpr uint8_t CLASSES = ZONES - 1;
+  static constexpr int16_t SERVE_R = 3;
+
+  // Word w of a row, T wide (rows are 32-bit words in memory)
+  template <class T>
+  static inline T load(const uint32_t *r, uint16_t w) {
+    T v;
+    memcpy(&v, r + w * (sizeof(T) / sizeof(uint32_t)), sizeof(T));
+    return v;
+  }
+  template <class T>
+  static inline void store(uint32_t *r, uint16_t w, T v) {
+    memcpy(r + w * (sizeof(T) / sizeof(uint32_t)), &v, sizeof(T));
+  }
+
+  // 0..8 as four bit-planes
+  template <class T>
+  struct Count {
+    T b0, b1, b2, b3;
+    T atLeast3() const { return (b0 & b1) | b2 | b3; }
+    T atLeast5() const { return b3 | (b2 & (b1 | b0)); }
+  };
+
+  template <class T>
+  void stepWords(const BitPlane *blocked) {
+    const uint16_t words = stride / (sizeof(T) / sizeof(uint32_t));
+    uint32_t *old[2][CLASSES];
+    for (uint8_t s = 0; s < 2; s++) {
+      for (uint8_t z = 0; z < CLASSES; z++) old[s][z] = save + (s * CLASSES + z) * stride;
+    }
+    uint8_t flip = 0;
+
+    for (uint16_t y = 0; y < H; y++) {
+      const uint32_t *up[CLASSES], *dn[CLASSES];
+      uint32_t *cur[CLASSES];
+      for (uint8_t z = 0; z < CLASSES; z++) {
+        up[z] = y > 0 ? old[flip ^ 1][z] : nullptr;
+        cur[z] = old[flip][z];
+        memcpy(cur[z], planes[z].row(y), stride * sizeof(uint32_t));
+        dn[z] = y + 1 < H ? planes[z].row(y + 1) : nullptr;
+      }
+      const uint32_t *srv = served.row(y);
+      const uint32_t *blk = blocked ? blocked->row(y) : nullptr;
+      uint32_t *outR = planes[0].row(y), *outC = planes[1].row(y), *outI = planes[2].row(y);
+
+      for (uint16_t w = 0; w < words; w++) {
+        Count<T> nR = neighbours<T>(up[0], cur[0], dn[0], w, words);
+        Count<T> nC = neighbours<T>(up[1], cur[1], dn[1], w, words);
+        Count<T> nI = neighbours<T>(up[2], cur[2], dn[2], w, words);
+        T r = load<T>(cur[0], w), c = load<T>(cur[1], w), i = load<T>(cur[2], w);
+        T keep = blk ? (T)~load<T>(blk, w) : (T)~(T)0;
+        T open = ~(r | c | i) & load<T>(srv, w) & keep;
+
+        T growI = open & nI.atLeast3();
+        T growC = open & ~growI & nC.atLeast3();
+        T growR = open & ~growI & ~growC & nR.atLeast3();
+        T toC = r & nC.atLeast5();
+        T toI = r & ~toC & nI.atLeast5();
+
+        store<T>(outR, w, ((r & ~toC & ~toI) | growR) & keep);
+        store<T>(outC, w, (c | growC | toC) & keep);
+        store<T>(outI, w, (i | growI | toI) & keep);
+      }
+      flip ^= 1;
+    }
+  }
+
+  // Word w of row r and its neighbours at x-1 and x+1 (rows outside the
+  // grid are nullptr and read as empty)
+  template <class T>
+  static void around(const uint32_t *r, uint16_t w, uint16_t words, T &l, T &m, T &rt) {
+    if (!r) { l = m = rt = 0; return; }
+    static constexpr uint8_t TOP = sizeof(T) * 8 - 1;
+    m = load<T>(r, w);
+    T prev = w > 0 ? load<T>(r, w - 1) : 0;
+    T next = w + 1 < words ? load<T>(r, w + 1) : 0;
+    l  = (m << 1) | (prev >> TOP);
+    rt = (m >> 1) | (next << TOP);
+  }
+
+  template <class T>
+  static inline void fullAdd(T a, T b, T c, T &sum, T &carry) {
+    T t = a ^ b;
+    sum = t ^ c;
+    carry = (a & b) | (t & c);
+  }
+
+  // Moore neighbour count of word w, one cell per bit
+  template <class T>
+  static Count<T> neighbours(const uint32_t *up, const uint32_t *cur, const uint32_t *dn,
+                             uint16_t w, uint16_t words) {
+    T ul, um, ur, cl, cm, cr, dl, dm, dr;
+    around<T>(up, w, words, ul, um, ur);
+    around<T>(cur, w, words, cl, cm, cr);
+    around<T>(dn, w, words, dl, dm, dr);
+    (void)cm;
+
+    // each row to two bits, then the three rows together
+    T su, ku, sd, kd;
+    fullAdd<T>(ul, um, ur, su, ku);
+    fullAdd<T>(dl, dm, dr, sd, kd);
+    T sc = cl ^ cr, kc = cl & cr;
+
+    Count<T> n;
+    T k1, t, k4a, k4b;
+    fullAdd<T>(su, sd, sc, n.b0, k1);     // ones; k1 carries a two
+    fullAdd<T>(ku, kd, kc, t, k4a);       // twos; k4a carries a four
+    n.b1 = t ^ k1;
+    k4b = t & k1;
+    n.b2 = k4a ^ k4b;
+    n.b3 = k4a & k4b;
+    return n;
+  }
+
+  uint16_t W = 0, H = 0, stride = 0;
+  BitPlane planes[CLASSES];      // housing, commerce, industry
+  BitPlane served;
+  uint32_t *save = nullptr;      // 2 rolling rows per class
+};
@@ -1,7 +1,21 @@
 #include <Arduino.h>
 #include <TFT_eSPI.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <driver/uart.h>
 #include "Pins.h"
-#include "CitySim.h"
+#include "Engines.h"
+#include "Palette.h"
+#include "Styles.h"
+#include "DayNight.h"
+#include "DirtyTiles.h"
+#include "Traffic.h"
+#include "Bench.h"
+#include "Fade.h"
+#include "ResetPolicy.h"
+#include "StepGovernor.h"
+#include "FrameScheduler.h"
+#include "BurnIn.h"
 
 // Landscape mode: 240 wide x 135 tall
 static constexpr int SCREEN_W = 240;
@@ -14,20 +28,77 @@ static constexpr int GRID_H = 135;
 TFT_eSPI tft = TFT_eSPI();
 TFT_eSprite spr = TFT_eSprite(&tft);
 
-CitySim city(GRID_W, GRID_H);
+// The live city generator (see CITY_ENGINES for the list)
+static EngineHost engine;
+
+// Active style is a pointer into the constexpr tables; the animator derives
+// animated colors from it and the bank shades them into the per-group LUTs
+// the conversion loop reads
+static uint8_t styleIndex = STYLE_SATELLITE;
+static PaletteAnimator palette;
+static DayNightCycle dayNight;
+static PaletteBank lutBank;
+static uint32_t lastPaletteMs = 0;
+static bool paletteStale = true;
+static uint32_t districtVersion = 0;   // DistrictMap::version() last copied
+static bool districtsStale = true;
+static const uint32_t PALETTE_ANIM_MS = 80;    // rebuild rate while animating
+static const uint32_t PALETTE_IDLE_MS = 500;   // day/night alone moves slowly
+
+// Screen tiles to reconvert and push this frame
+static DirtyTiles frameDirty;
+static DirtyTiles fadeDirty;      // grid tiles the fade moved this frame
+
+// Which LUT bands (PaletteBank::BAND_SHIFT) each screen tile showed when it
+// was last converted, so a palette change only reconverts the tiles that
+// use what changed. Never-converted tiles match everything.
+static uint32_t tileBands[DirtyTiles::MAX_ROWS][16];
+
+// What's on screen eases toward the sim grid over a few frames
+static FadeBuffer fade;
+
+// Cars drawn over the converted frame (never written into the sim), and
+// the box around each clean tile's car pixels, pushed as one rect
+static TrafficOverlay traffic;
+struct CarBox { int16_t x0, y0, x1, y1; uint16_t n; };
+static CarBox carBoxes[DirtyTiles::MAX_ROWS][16];
+static const int16_t WINDOW_COST_PX = 12;   // an SPI window costs about as much as this many pixels
+
+// Slow orbit shift and idle dimming, applied at conversion
+static BurnInGuard burnIn;
+
+// HUD box (redrawn whenever anything under it is reconverted)
+static const int16_t HUD_X0 = 4, HUD_Y0 = 4, HUD_X1 = 100, HUD_Y1 = 28;
+static bool hudStale = true;
+
+// Glow layer value -> intensity added on top of the road layer (~5/8 gain)
+struct GlowCurve { uint8_t v[256]; };
+static constexpr GlowCurve makeGlowCurve() {
+  GlowCurve c{};
+  for (uint16_t g = 0; g < 256; g++) c.v[g] = (uint8_t)(g * 5 / 8);
+  return c;
+}
+static constexpr GlowCurve GLOW_CURVE_TABLE = makeGlowCurve();
+static const uint8_t *const GLOW_CURVE = GLOW_CURVE_TABLE.v;
 
-// Speed control: frames to skip between sim steps (higher = slower)
-// Level 0: 1 step every 6 frames (~10 steps/sec) - very slow
-// Level 1: 1 step every 2 frames (~30 steps/sec)
-// Level 2: 1 step per frame (~60 steps/sec)
-// Level 3: 3 steps per frame (~180 steps/sec)
-static const uint8_t SPEED_FRAME_SKIP[] = {6, 2, 1, 1};
-static const uint8_t SPEED_STEPS[] = {1, 1, 1, 3};
+// Speed control: each level is a target sim rate in steps per second. The
+// governor works out how many steps that is each frame from the measured
+// step cost, within its per-frame budget (TURBO is usually budget-bound).
+static const uint16_t SPEED_RATES[] = {10, 30, 60, 600};
 static const char* SPEED_NAMES[] = {"SLOW", "MED", "FAST", "TURBO"};
 static uint8_t speedLevel = 0;  // Start at slowest
-static uint8_t frameCount = 0;
-static uint32_t lastResetTime = 0;
-static const uint32_t AUTO_RESET_MS = 15 * 60 * 1000;  // 15 minutes
+static StepGovernor governor;
+static ResetPolicy resetPolicy;   // when to start over on its own
+
+// Power saving: a slower CPU, a frame rate that drops when little changes,
+// and light sleep through the wait between frames. The sim rate doesn't
+// depend on any of it (see StepGovernor).
+#ifndef POWER_SAVE
+#define POWER_SAVE 1
+#endif
+static FrameScheduler frames;
+static const uint32_t POWER_CPU_MHZ = 80;   // APB stays at 80 MHz, so SPI is unaffected
+static const uint32_t FULL_CPU_MHZ = 240;
 
 // 80s synthwave colors
 static const uint16_t NEON_PINK = 0xF81F;    // Hot pink
@@ -96,33 +167,6 @@ void showSplash() {
   delay(2500);
 }
 
-// Map intensity -> “night satellite” color
-// (keep it simple: dark blues for low, warm whites for high)
-static inline uint16_t satColor(uint8_t v) {
-  // Background almost black
-  if (v < 10) return tft.color565(0, 0, 6);
-
-  // Road glow region (cool)
-  if (v < 80) {
-    uint8_t b = 10 + (v / 3);
-    uint8_t g = 4 + (v / 10);
-    uint8_t r = 0;
-    return tft.color565(r, g, b);
-  }
-
-  // City lights (warm)
-  uint8_t x = v - 80; // 0..175
-  uint8_t r = 30 + (x);
-  uint8_t g = 22 + (x * 7) / 10;
-  uint8_t b = 10 + (x * 2) / 10;
-
-  r = (r > 255) ? 255 : r;
-  g = (g > 255) ? 255 : g;
-  b = (b > 255) ? 255 : b;
-
-  return tft.color565(r, g, b);
-}
-
 void setupButtons() {
   pinMode(PIN_BTN_LEFT, INPUT_PULLUP);
   pinMode(PIN_BTN_RIGHT, INPUT); // GPIO35 has no pullups on many ESP32 boards
@@ -138,11 +182,34 @@ bool rightPressed() {
   return digitalRead(PIN_BTN_RIGHT) == LOW;
 }
 
+// Buttons and serial input end a light sleep early. The serial bytes that
+// wake the board are lost, so a key may need pressing twice.
+void setupWakeups() {
+  gpio_wakeup_enable((gpio_num_t)PIN_BTN_LEFT, GPIO_INTR_LOW_LEVEL);
+  gpio_wakeup_enable((gpio_num_t)PIN_BTN_RIGHT, GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+  uart_set_wakeup_threshold(UART_NUM_0, 3);
+  esp_sleep_enable_uart_wakeup(0);
+}
+
+void setPowerSave(bool on) {
+  // Let pending output out before the UART clock changes
+  Serial.flush();
+  setCpuFrequencyMhz(on ? POWER_CPU_MHZ : FULL_CPU_MHZ);
+  frames.setPowerSave(on);
+  Serial.printf("power save: %s, %lu MHz, frames %lu us busy / %lu us idle (%u.%u%%)\n",
+                on ? "on" : "off", (unsigned long)getCpuFrequencyMhz(),
+                (unsigned long)frames.activeUs(), (unsigned long)frames.idleUs(),
+                frames.duty() / 10, frames.duty() % 10);
+}
+
 void setup() {
   Serial.begin(115200);
   delay(200);
 
   setupButtons();
+  setupWakeups();
+  setPowerSave(POWER_SAVE);
 
   tft.init();
   tft.setRotation(1); // try 1 or 3 if rotated weird
@@ -156,68 +223,398 @@ void setup() {
 
   spr.createSprite(SCREEN_W, SCREEN_H);
 
+  palette.setBase(STYLE_TABLES[styleIndex]);
+  dayNight.init(SCREEN_W, SCREEN_H);
+  frameDirty.init(SCREEN_W, SCREEN_H);
+  fadeDirty.init(GRID_W, GRID_H);
+  memset(tileBands, 0xFF, sizeof(tileBands));
+  traffic.init(SCREEN_W, SCREEN_H);
+  if (fade.init(GRID_W, GRID_H)) engine.setChangeList(&fade.pending());
+
   showSplash();
-  city.reset();
-  lastResetTime = millis();
+  engine.select(CITY_ENGINE, GRID_W, GRID_H, esp_random());
+  resetPolicy.start(millis());
+  burnIn.start(millis());
+  governor.setRate(SPEED_RATES[speedLevel]);
+}
+
+void selectStyle(uint8_t s) {
+  styleIndex = s % STYLE_COUNT;
+  palette.setBase(STYLE_TABLES[styleIndex]);
+  paletteStale = true;
+  Serial.printf("style: %s\n", STYLE_NAMES[styleIndex]);
+}
+
+// Start a fresh city on another engine
+void selectEngine(uint8_t id) {
+  if (!engine.select(id, GRID_W, GRID_H, esp_random())) {
+    Serial.printf("engine %s: no memory\n", ENGINE_NAMES[id % ENGINE_COUNT]);
+  }
+  traffic.clear();
+  districtsStale = true;
+  hudStale = true;
+  resetPolicy.start(millis());
+  Serial.printf("engine: %s\n", engine.name());
+}
+
+// Serial commands: 1-5 pick a style, 's' cycles styles,
+// 'a' toggles palette animation, 'n' toggles the day/night cycle,
+// 't' toggles traffic, 'f' toggles fade-in, 'e' cycles engines,
+// 'b' runs the benchmarks (restarts the city), 'p' toggles power saving,
+// 'o' toggles the burn-in guard
+void handleSerial() {
+  while (Serial.available() > 0) {
+    int c = Serial.read();
+    burnIn.wake(millis());
+    if (c >= '1' && c < '1' + STYLE_COUNT) {
+      selectStyle(c - '1');
+    } else if (c == 's') {
+      selectStyle(styleIndex + 1);
+    } else if (c == 'a') {
+      palette.setEnabled(!palette.isEnabled());
+      paletteStale = true;
+      Serial.printf("animation: %s\n", palette.isEnabled() ? "on" : "off");
+    } else if (c == 'n') {
+      dayNight.setEnabled(!dayNight.isEnabled());
+      paletteStale = true;
+      Serial.printf("day/night: %s\n", dayNight.isEnabled() ? "on" : "off");
+    } else if (c == 't') {
+      traffic.setEnabled(!traffic.isEnabled());
+      Serial.printf("traffic: %s\n", traffic.isEnabled() ? "on" : "off");
+    } else if (c == 'f') {
+      fade.setEnabled(!fade.isEnabled());
+      Serial.printf("fade: %s\n", fade.isEnabled() ? "on" : "off");
+    } else if (c == 'o') {
+      burnIn.setEnabled(!burnIn.isEnabled());
+      paletteStale = true;
+      hudStale = true;
+      frameDirty.markAll();
+      Serial.printf("burn-in guard: %s\n", burnIn.isEnabled() ? "on" : "off");
+    } else if (c == 'p') {
+      setPowerSave(!frames.powerSaving());
+    } else if (c == 'e') {
+      selectEngine(engine.engine() + 1);
+    } else if (c == 'b') {
+      uint8_t current = engine.engine();
+      bench::agentMotion(GRID_W, GRID_H);
+      bench::zoning(GRID_W, GRID_H);
+      bench::engines(engine, GRID_W, GRID_H);
+      selectEngine(current);
+    }
+  }
+}
+
+void resetCity() {
+  showSplash();
+  engine.reset(esp_random());
+  resetPolicy.start(millis());
+  traffic.clear();
+  districtsStale = true;
+  paletteStale = true;
+  hudStale = true;
 }
 
 void handleInput() {
   static uint32_t lastPress = 0;
   uint32_t now = millis();
 
+  handleSerial();
+  if (leftPressed() || rightPressed()) burnIn.wake(now);
+
   if (now - lastPress < 200) return;
 
+  // Both buttons together: next style
+  if (leftPressed() && rightPressed()) {
+    selectStyle(styleIndex + 1);
+    lastPress = now;
+    return;
+  }
+
   if (leftPressed()) {
     // Cycle through speed levels (0 -> 1 -> 2 -> 3 -> 0)
     speedLevel = (speedLevel + 1) % 4;
+    governor.setRate(SPEED_RATES[speedLevel]);
+    Serial.printf("speed: %s, %u steps/s, %lu us/step\n", SPEED_NAMES[speedLevel],
+                  SPEED_RATES[speedLevel], (unsigned long)governor.stepCostUs());
+    hudStale = true;
     lastPress = now;
   }
 
   if (rightPressed()) {
-    showSplash();
-    city.reset();
-    lastResetTime = now;
+    resetCity();
     lastPress = now;
   }
 
-  // Auto-reset after 15 minutes to prevent screen burnout
-  if (now - lastResetTime >= AUTO_RESET_MS) {
-    showSplash();
-    city.reset();
-    lastResetTime = now;
+  // Start over once the city is blown out, static, or just very old
+  if (engine.ready()) {
+    ResetPolicy::Reason why = resetPolicy.check(now, engine.grid());
+    if (why != ResetPolicy::KEEP) {
+      Serial.printf("auto-reset: %s\n", ResetPolicy::name(why));
+      resetCity();
+    }
   }
 }
 
-void drawFrame() {
-  spr.fillSprite(TFT_BLACK);
+// Each district runs the day/night cycle as its own LUT group. With a
+// single district (nothing founded yet) fall back to random blocks.
+// Returns true if the group map changed.
+bool syncDistricts() {
+  const DistrictMap &d = engine.grid().districtMap();
+  if (!districtsStale && d.version() == districtVersion) return false;
+  districtsStale = false;
+  districtVersion = d.version();
+  if (d.count() < 2) {
+    dayNight.randomizeGroups();
+    return true;
+  }
+  for (uint8_t cy = 0; cy < d.cellRows(); cy++) {
+    for (uint8_t cx = 0; cx < d.cellCols(); cx++) dayNight.setGroup(cx, cy, d.at(cx, cy));
+  }
+  return true;
+}
+
+// Rebuild the LUT bank when it's due. Returns the intensity bands whose
+// entries actually changed (0 if none), for markBands().
+uint32_t refreshPalette(uint32_t now) {
+  uint32_t interval = palette.isEnabled() ? PALETTE_ANIM_MS : PALETTE_IDLE_MS;
+  if (!paletteStale && now - lastPaletteMs < interval) return 0;
+  lastPaletteMs = now;
+  paletteStale = false;
+
+  palette.update(now);
+  dayNight.prepare(now);
+  uint16_t dim = burnIn.dim();
+  return lutBank.build(palette.colors(), [dim](uint8_t g, uint8_t v) {
+    return (uint16_t)((dayNight.shade(g, v) * dim) >> 8);
+  });
+}
 
-  // Run sim steps based on speed level (with frame skipping for slow speeds)
-  frameCount++;
-  if (frameCount >= SPEED_FRAME_SKIP[speedLevel]) {
-    frameCount = 0;
-    for (int i = 0; i < SPEED_STEPS[speedLevel]; i++) {
-      city.step();
+// Reconvert the tiles that show an intensity in one of the changed bands
+void markBands(uint32_t bands) {
+  for (uint8_t ty = 0; ty < frameDirty.tileRows(); ty++) {
+    for (uint8_t tx = 0; tx < frameDirty.tileCols(); tx++) {
+      if (tileBands[ty][tx] & bands) frameDirty.mark(tx << DirtyTiles::SHIFT, ty << DirtyTiles::SHIFT);
     }
   }
+}
 
-  // Draw pixels
-  for (int y = 0; y < GRID_H; y++) {
-    for (int x = 0; x < GRID_W; x++) {
-      uint8_t v = city.get(x, y);
-      spr.drawPixel(x, y, satColor(v));
+// Convert one pixel rect (inclusive) from displayed intensity to color
+// straight into the sprite buffer, compositing the glow layer with a
+// saturating add.
+// The LUT is picked per 8-pixel cell from the day/night group map, and per
+// pixel by land-use class: one packed word covers the cell's 8 pixels and
+// is shifted down 2 bits a pixel.
+// The rect is in screen pixels, which show the grid moved by the burn-in
+// orbit offset; pixels shifted in from outside the grid are empty ground.
+// It covers whole tiles, whose tileBands are redone from what's drawn
+// (per 8-pixel chunk, credited to the tiles at both ends of the chunk).
+void convertRect(uint16_t *dst, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  const GridEngine &city = engine.grid();
+  const uint8_t *src = fade.valid() ? fade.data() : city.data();
+  const uint8_t *glow = city.glowData();
+  const LandUse &land = city.landUse();
+  const int8_t ox = burnIn.offsetX(), oy = burnIn.offsetY();
+  const uint8_t BAND = PaletteBank::BAND_SHIFT;
+  for (int16_t ty = y0 >> DirtyTiles::SHIFT; ty <= (y1 >> DirtyTiles::SHIFT); ty++) {
+    for (int16_t tx = x0 >> DirtyTiles::SHIFT; tx <= (x1 >> DirtyTiles::SHIFT); tx++) tileBands[ty][tx] = 0;
+  }
+  for (int16_t y = y0; y <= y1; y++) {
+    uint16_t *out = dst + (uint32_t)y * SCREEN_W;
+    uint32_t *bands = tileBands[y >> DirtyTiles::SHIFT];
+    int16_t gy = y - oy;
+    int16_t gx0 = x0 - ox, gx1 = x1 - ox;
+    const uint8_t *groups = dayNight.groupRow(constrain(gy, 0, GRID_H - 1) >> DayNightCycle::CELL_SHIFT);
+    auto empty = [&](int16_t x) {
+      int16_t gx = constrain(x - ox, 0, GRID_W - 1);
+      out[x] = lutBank.lut(groups[gx >> DayNightCycle::CELL_SHIFT])[0];
+      bands[x >> DirtyTiles::SHIFT] |= 1;
+    };
+    if (gy < 0 || gy >= GRID_H) {
+      for (int16_t x = x0; x <= x1; x++) empty(x);
+      continue;
     }
+    for (; gx0 < 0; gx0++) empty(gx0 + ox);
+    for (; gx1 >= GRID_W; gx1--) empty(gx1 + ox);
+
+    const uint32_t *classes = land.valid() ? land.row(gy) : nullptr;
+    uint32_t row = (uint32_t)gy * GRID_W;
+    out += ox;   // indexed by grid x from here
+    for (int16_t cx = gx0; cx <= gx1; cx = (cx | 7) + 1) {
+      const uint16_t *lut = lutBank.lut(groups[cx >> DayNightCycle::CELL_SHIFT]);
+      int16_t end = min<int16_t>(gx1, cx | 7);
+      uint32_t cls = classes ? classes[cx >> 4] >> ((cx & 15) * 2) : 0;
+      uint32_t seen = 0;
+      if (glow) {
+        for (int16_t x = cx; x <= end; x++, cls >>= 2) {
+          uint16_t v = src[row + x] + GLOW_CURVE[glow[row + x]];
+          if (v > 255) v = 255;
+          out[x] = lut[((cls & 3) << 8) | v];
+          seen |= 1u << (v >> BAND);
+        }
+      } else {
+        for (int16_t x = cx; x <= end; x++, cls >>= 2) {
+          uint8_t v = src[row + x];
+          out[x] = lut[((cls & 3) << 8) | v];
+          seen |= 1u << (v >> BAND);
+        }
+      }
+      bands[(cx + ox) >> DirtyTiles::SHIFT] |= seen;
+      bands[(end + ox) >> DirtyTiles::SHIFT] |= seen;
+    }
+  }
+}
+
+// Returns how many screen tiles the sim changed (see the end)
+uint16_t drawFrame() {
+  if (!engine.ready()) return 0;
+  GridEngine &city = engine.grid();
+
+  // As many sim steps as the speed level's rate calls for since last frame,
+  // timed so the governor learns what a step costs. Up to half the frame
+  // period goes on stepping, so the sim rate holds when the frame rate drops.
+  uint16_t steps = governor.plan(micros(), frames.periodUs() / 2);
+  if (steps) {
+    uint32_t t0 = micros();
+    engine.stepN(steps);
+    governor.record(steps, micros() - t0);
+  }
+
+  // Recently changed cells step toward their new value. The glow is
+  // blurred from those displayed values, so a new road's halo fades in with
+  // it; it only catches up where they moved (or, without the fade, where
+  // the city changed).
+  if (fade.valid()) {
+    fadeDirty.clear();
+    fade.step(city.data(), fadeDirty);
+    city.updateGlow(fade.data(), fadeDirty);
+    frameDirty.merge(fadeDirty);
+  } else {
+    city.updateGlow();
+  }
+  frameDirty.merge(city.dirtyTiles());
+  city.clearDirty();
+
+  // Grid tiles to screen tiles under the orbit offset; a new offset, like a
+  // new palette, recolors everything
+  frameDirty.shift(burnIn.offsetX(), burnIn.offsetY());
+  uint16_t simTiles = frameDirty.count();
+  if (burnIn.update(millis())) {
+    paletteStale = true;
+    hudStale = true;
+    frameDirty.markAll();
+  }
+
+  // Palette changes (animation, time of day, style) recolor the tiles that
+  // show the intensities whose colors moved, and a new district map
+  // recolors everything; beyond that only tiles the sim touched are
+  // converted and sent
+  uint32_t changedBands = refreshPalette(millis());
+  if (changedBands) markBands(changedBands);
+  if (syncDistricts()) frameDirty.markAll();
+  const int16_t hx = HUD_X0 + burnIn.offsetX(), hy = HUD_Y0 + burnIn.offsetY();
+  const int16_t hx1 = HUD_X1 + burnIn.offsetX(), hy1 = HUD_Y1 + burnIn.offsetY();
+  if (hudStale) frameDirty.markRect(hx, hy, hx1, hy1);
+
+  uint16_t *dst = (uint16_t*)spr.getPointer();
+  if (!dst) return 0;
+
+  // Cars come off before conversion so save-under stays consistent
+  traffic.erase(dst);
+  traffic.update(city.data());
+  traffic.setOffset(burnIn.offsetX(), burnIn.offsetY());
+
+  for (uint8_t ty = 0; ty < frameDirty.tileRows(); ty++) {
+    DirtyTiles::forEachRun(frameDirty.row(ty), [&](uint8_t tx0, uint8_t tx1) {
+      int16_t y0 = ty * DirtyTiles::TILE;
+      int16_t y1 = min<int16_t>(SCREEN_H - 1, y0 + DirtyTiles::TILE - 1);
+      int16_t x0 = tx0 * DirtyTiles::TILE;
+      int16_t x1 = min<int16_t>(SCREEN_W - 1, (tx1 + 1) * DirtyTiles::TILE - 1);
+      convertRect(dst, x0, y0, x1, y1);
+    });
+  }
+
+  // Minimal HUD, redrawn if anything underneath was reconverted
+  if (hudStale || frameDirty.intersects(hx, hy, hx1, hy1)) {
+    spr.setTextColor(TFT_GREEN, TFT_BLACK);
+    spr.drawString(SPEED_NAMES[speedLevel], hx, hy, 2);
+    spr.drawString("L:speed  R:reset", hx, hy + 16, 1);
+    frameDirty.markRect(hx, hy, hx1, hy1);
+    hudStale = false;
+  }
+
+  // Cars last, so what they save under includes the HUD
+  traffic.draw(dst);
+
+  // Only dirty tile runs go over SPI
+  for (uint8_t ty = 0; ty < frameDirty.tileRows(); ty++) {
+    DirtyTiles::forEachRun(frameDirty.row(ty), [&](uint8_t tx0, uint8_t tx1) {
+      int16_t y = ty * DirtyTiles::TILE;
+      int16_t h = min<int16_t>(SCREEN_H - y, DirtyTiles::TILE);
+      int16_t x = tx0 * DirtyTiles::TILE;
+      int16_t w = min<int16_t>(SCREEN_W - x, (tx1 - tx0 + 1) * DirtyTiles::TILE);
+      spr.pushSprite(x, y, x, y, w, h);
+    });
   }
 
-  // Minimal HUD
-  spr.setTextColor(TFT_GREEN, TFT_BLACK);
-  spr.drawString(SPEED_NAMES[speedLevel], 4, 4, 2);
-  spr.drawString("L:speed  R:reset", 4, 20, 1);
+  // Car pixels outside those tiles: per tile, one rect around the pixels
+  // touched in it (a car's old and new spot are usually adjacent) when
+  // that's cheaper than a window per pixel, else pixel by pixel
+  uint16_t carTiles[DirtyTiles::MAX_ROWS] = {};
+  uint16_t carSingles[DirtyTiles::MAX_ROWS] = {};
+  const uint16_t *touched = traffic.touchedPixels();
+  for (uint16_t i = 0; i < traffic.touchedSize(); i++) {
+    int16_t x = touched[i] % SCREEN_W, y = touched[i] / SCREEN_W;
+    if (frameDirty.test(x, y)) continue;
+    uint8_t tx = x >> DirtyTiles::SHIFT, ty = y >> DirtyTiles::SHIFT;
+    CarBox &b = carBoxes[ty][tx];
+    if (!(carTiles[ty] & (1u << tx))) {
+      carTiles[ty] |= (uint16_t)(1u << tx);
+      b = CarBox{x, y, x, y, 1};
+    } else {
+      b.x0 = min(b.x0, x); b.x1 = max(b.x1, x);
+      b.y0 = min(b.y0, y); b.y1 = max(b.y1, y);
+      b.n++;
+    }
+  }
+  for (uint8_t ty = 0; ty < frameDirty.tileRows(); ty++) {
+    for (uint16_t m = carTiles[ty]; m; m &= m - 1) {
+      uint8_t tx = __builtin_ctz(m);
+      const CarBox &b = carBoxes[ty][tx];
+      int16_t w = b.x1 - b.x0 + 1, h = b.y1 - b.y0 + 1;
+      if (w * h - b.n <= (b.n - 1) * WINDOW_COST_PX) spr.pushSprite(b.x0, b.y0, b.x0, b.y0, w, h);
+      else carSingles[ty] |= (uint16_t)(1u << tx);
+    }
+  }
+  for (uint16_t i = 0; i < traffic.touchedSize(); i++) {
+    int16_t x = touched[i] % SCREEN_W, y = touched[i] / SCREEN_W;
+    if (carSingles[y >> DirtyTiles::SHIFT] & (1u << (x >> DirtyTiles::SHIFT))) spr.pushSprite(x, y, x, y, 1, 1);
+  }
 
-  spr.pushSprite(0, 0);
+  // What the sim changed sets the frame rate. Palette animation and moving
+  // cars count as one tile: enough to stay off the idle rate, not to force
+  // 60 fps for a LUT that moves every 80 ms. Slow recolors (time of day,
+  // orbit steps) don't count; 10 fps shows them fine.
+  uint16_t changed = simTiles;
+  bool recolored = frameDirty.count() > simTiles;
+  if ((recolored && palette.isEnabled()) || traffic.touchedSize()) changed++;
+  frameDirty.clear();
+  return changed;
 }
 
 void loop() {
+  frames.beginFrame(micros());
   handleInput();
-  drawFrame();
-  delay(16); // ~60fps-ish. Raise this if it’s too busy.
+  uint16_t changed = drawFrame();
+
+  // Frames are paced by the scheduler but otherwise take as long as they
+  // take; the sim keeps wall-clock time on its own
+  uint32_t waitUs = frames.endFrame(micros(), changed);
+  if (frames.shouldSleep(waitUs)) {
+    Serial.flush();
+    esp_sleep_enable_timer_wakeup(waitUs);
+    esp_light_sleep_start();
+  } else if (waitUs) {
+    delay(waitUs / 1000);
+    delayMicroseconds(waitUs % 1000);
+  }
 }
@@ -0,0 +1,31 @@
+// The on-device benchmarks ('b' in the console) built for the host, plus
+// the reaction-diffusion vector kernel timed against the scalar loop.
+// Not a test: run build-host/bench_host and read the figures.
+#include <Arduino.h>
+#include "Bench.h"
+
+#if RD_SIMD
+// Steps/s of the reaction engine over the bench run, one kernel or the other
+static uint32_t reactionRate(bool simd) {
+  static ReactionDiffusion e(240, 135);
+  e.setSimd(simd);
+  e.reset(ENGINE_BENCH_SEED);
+  uint32_t t0 = micros();
+  for (uint16_t i = 0; i < ENGINE_BENCH_STEPS; i++) e.step();
+  uint32_t us = micros() - t0;
+  return us ? (uint32_t)((uint64_t)ENGINE_BENCH_STEPS * 1000000ULL / us) : 0;
+}
+#endif
+
+int main() {
+  static EngineHost host;
+  bench::engines(host, 240, 135);
+  bench::agentMotion(240, 135);
+  bench::zoning(240, 135);
+#if RD_SIMD
+  uint32_t scalar = reactionRate(false), simd = reactionRate(true);
+  printf("reaction kernel: scalar %lu steps/s, vector %lu steps/s\n",
+         (unsigned long)scalar, (unsigned long)simd);
+#endif
+  return 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdio.h>
+
+// Minimal assertions for the host tests: a failed CHECK prints where and
+// counts, and main() returns checkResult() so ctest sees the failure.
+inline int &checkFailures() {
+  static int n = 0;
+  return n;
+}
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      checkFailures()++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(a, b) \
+  do { \
+    auto va_ = (a); auto vb_ = (b); \
+    if (!(va_ == vb_)) { \
+      printf("%s:%d: CHECK_EQ failed: %s = %lld, %s = %lld\n", __FILE__, __LINE__, \
+             #a, (long long)va_, #b, (long long)vb_); \
+      checkFailures()++; \
+    } \
+  } while (0)
+
+inline int checkResult() {
+  if (checkFailures()) printf("%d check(s) failed\n", checkFailures());
+  else printf("ok\n");
+  return checkFailures() ? 1 : 0;
+}
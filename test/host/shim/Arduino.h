@@ -0,0 +1,44 @@
+#pragma once
+// Just enough of the Arduino core to compile the headers in include/ on a
+// desktop compiler for the host tests. esp_random() is seedable so test
+// runs are repeatable.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define IRAM_ATTR
+
+inline uint32_t &hostRandomState() {
+  static uint32_t s = 0x12345678u;
+  return s;
+}
+inline void hostRandomSeed(uint32_t s) { hostRandomState() = s ? s : 1; }
+inline uint32_t esp_random() {
+  uint32_t &s = hostRandomState();
+  s ^= s << 13;
+  s ^= s >> 17;
+  s ^= s << 5;
+  return s;
+}
+
+inline uint32_t micros() {
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+inline uint32_t millis() { return micros() / 1000; }
+
+struct HostSerial {
+  template <class... A> void printf(const char *f, A... a) { ::printf(f, a...); }
+  void println(const char *s) { ::printf("%s\n", s); }
+  void println() { ::printf("\n"); }
+};
+inline HostSerial Serial;
@@ -0,0 +1,36 @@
+// Aggregation: every attach lights a new pixel (a walker never sticks to a
+// pixel already in the cluster), and a cluster that has outgrown the
+// screen reports finished() and stops changing rather than filling in.
+#include <Arduino.h>
+#include "Aggregation.h"
+#include "check.h"
+
+static uint32_t litPixels(const GridEngine &g) {
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < (uint32_t)g.width() * g.height(); i++) n += g.data()[i] != 0;
+  return n;
+}
+
+static void runSeed(uint32_t seed) {
+  static Aggregation a(240, 135);
+  CHECK(a.valid());
+  a.reset(seed);
+  uint16_t steps = 0;
+  while (!a.finished() && steps < 10000) {
+    a.step();
+    if (++steps % 250 == 0) CHECK_EQ(a.metricCount(), litPixels(a));
+  }
+  CHECK(a.finished());
+  CHECK_EQ(a.metricCount(), litPixels(a));
+  // well short of the saturation reset
+  CHECK(a.saturation() < 100);
+
+  uint32_t h = a.hash();
+  for (uint8_t i = 0; i < 50; i++) a.step();
+  CHECK_EQ(a.hash(), h);
+}
+
+int main() {
+  for (uint32_t seed = 1; seed <= 6; seed++) runSeed(seed * 2654435761u);
+  return checkResult();
+}
@@ -0,0 +1,25 @@
+// Every engine in CITY_ENGINES, run from the bench seed for the bench step
+// count, must reproduce the grid hash recorded next to it, and do so again
+// after a fresh select() (nothing leaks between runs).
+#include <Arduino.h>
+#include "Engines.h"
+#include "check.h"
+
+int main() {
+  static EngineHost host;
+  for (uint8_t id = 0; id < ENGINE_COUNT; id++) {
+    uint32_t hash[2] = {0, 0};
+    for (uint8_t run = 0; run < 2; run++) {
+      CHECK(host.select(id, 240, 135, ENGINE_BENCH_SEED));
+      host.stepN(ENGINE_BENCH_STEPS);
+      hash[run] = host.grid().hash();
+    }
+    printf("%s: hash %08lx, golden %08lx\n", ENGINE_NAMES[id],
+           (unsigned long)hash[0], (unsigned long)ENGINE_GOLDEN[id]);
+    // 0 = not recorded yet: record the printed hash in CITY_ENGINES
+    CHECK(ENGINE_GOLDEN[id] != 0);
+    CHECK_EQ(hash[0], ENGINE_GOLDEN[id]);
+    CHECK_EQ(hash[1], hash[0]);
+  }
+  return checkResult();
+}
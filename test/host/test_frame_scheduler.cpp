@@ -0,0 +1,77 @@
+// FrameScheduler against a fake clock: frames take `work` us and then wait
+// whatever endFrame() asks for, so the rate and duty it settles on can be
+// read straight off the clock.
+#include <Arduino.h>
+#include "FrameScheduler.h"
+#include "check.h"
+
+struct Run {
+  uint32_t elapsedUs = 0;
+  uint16_t sleeps = 0;
+  uint16_t frames = 0;
+  uint32_t fps10() const { return (uint32_t)((uint64_t)frames * 10000000ULL / elapsedUs); }
+};
+
+static uint32_t clockUs = 1000;
+
+static Run frames(FrameScheduler &f, uint16_t n, uint32_t work, uint16_t tiles) {
+  Run r;
+  uint32_t t0 = clockUs;
+  for (uint16_t i = 0; i < n; i++) {
+    f.beginFrame(clockUs);
+    clockUs += work;
+    uint32_t wait = f.endFrame(clockUs, tiles);
+    if (f.shouldSleep(wait)) r.sleeps++;
+    clockUs += wait;
+  }
+  r.elapsedUs = clockUs - t0;
+  r.frames = n;
+  return r;
+}
+
+int main() {
+  FrameScheduler f;
+  f.setPowerSave(true);
+
+  // Lots changing: 60 fps, sleeping through the rest of each frame
+  Run busy = frames(f, 100, 3000, 20);
+  CHECK_EQ(f.periodUs(), FrameScheduler::FAST_US);
+  CHECK(busy.fps10() >= 595 && busy.fps10() <= 605);
+  CHECK_EQ(busy.sleeps, busy.frames);
+
+  // A tile now and then: 30 fps
+  Run trickle = frames(f, 100, 2000, 1);
+  CHECK_EQ(f.periodUs(), FrameScheduler::CALM_US);
+  CHECK(trickle.fps10() >= 295 && trickle.fps10() <= 305);
+
+  // Nothing changing: 10 fps, mostly asleep
+  frames(f, FrameScheduler::QUIET_FRAMES, 1000, 0);
+  Run quiet = frames(f, 100, 1000, 0);
+  CHECK_EQ(f.periodUs(), FrameScheduler::IDLE_US);
+  CHECK(quiet.fps10() >= 99 && quiet.fps10() <= 101);
+  CHECK(f.duty() <= 20);
+  CHECK_EQ(quiet.sleeps, quiet.frames);
+
+  // A few tiles wake it to 30 fps, a burst straight back to 60 (tiles are
+  // judged per 60 fps frame, so 10 tiles in a 10 fps frame are only ~2)
+  frames(f, 1, 2000, 10);
+  CHECK_EQ(f.periodUs(), FrameScheduler::CALM_US);
+  frames(f, FrameScheduler::QUIET_FRAMES, 1000, 0);
+  frames(f, 1, 2000, 40);
+  CHECK_EQ(f.periodUs(), FrameScheduler::FAST_US);
+
+  // Frames longer than the period: no wait, so no sleep
+  Run over = frames(f, 100, 20000, 50);
+  CHECK_EQ(over.sleeps, 0);
+  CHECK(over.fps10() >= 499 && over.fps10() <= 501);
+  CHECK(f.duty() >= 990);
+
+  // Power saving off: a fixed 60 fps whatever changes, never sleeping
+  f.setPowerSave(false);
+  Run off = frames(f, 100, 3000, 0);
+  CHECK_EQ(f.periodUs(), FrameScheduler::FAST_US);
+  CHECK(off.fps10() >= 595 && off.fps10() <= 605);
+  CHECK_EQ(off.sleeps, 0);
+
+  return checkResult();
+}
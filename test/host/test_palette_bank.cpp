@@ -0,0 +1,47 @@
+// PaletteBank::build() skips entries whose inputs didn't move and copies
+// between groups with equal shades; over an animated day/night run its
+// tables must stay identical to building every entry from scratch, and the
+// band mask it returns must name every band with a changed entry.
+#include <Arduino.h>
+#include "Palette.h"
+#include "DayNight.h"
+#include "Styles.h"
+#include "check.h"
+
+static uint16_t reference[LUT_GROUPS][LAND_CLASSES][256];
+
+int main() {
+  static PaletteBank bank;
+  static PaletteAnimator palette;
+  static DayNightCycle dayNight;
+  dayNight.init(240, 135);
+  dayNight.setCycleMs(60000);
+
+  for (uint8_t style = 0; style < STYLE_COUNT; style++) {
+    palette.setBase(STYLE_TABLES[style]);
+    for (uint32_t ms = 0; ms < 120000; ms += 80) {
+      palette.setEnabled((ms / 20000) % 2 == 0);
+      palette.update(ms);
+      dayNight.prepare(ms);
+      auto shade = [](uint8_t g, uint8_t v) { return dayNight.shade(g, v); };
+
+      uint16_t before[LUT_GROUPS][LAND_CLASSES][256];
+      for (uint8_t g = 0; g < LUT_GROUPS; g++) memcpy(before[g], bank.lut(g), sizeof(before[g]));
+      uint32_t bands = bank.build(palette.colors(), shade);
+
+      uint32_t expect = 0;
+      for (uint8_t g = 0; g < LUT_GROUPS; g++) {
+        for (uint16_t v = 0; v < 256; v++) {
+          uint16_t base = scale565(palette.colors()[v], shade(g, (uint8_t)v));
+          for (uint8_t cls = 0; cls < LAND_CLASSES; cls++) {
+            reference[g][cls][v] = swap565(landTint565(base, cls, (uint8_t)v));
+            if (reference[g][cls][v] != before[g][cls][v]) expect |= 1u << (v >> PaletteBank::BAND_SHIFT);
+          }
+        }
+        CHECK(memcmp(bank.lut(g), reference[g], sizeof(reference[g])) == 0);
+      }
+      CHECK_EQ(bands, expect);
+    }
+  }
+  return checkResult();
+}
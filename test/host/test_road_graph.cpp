@@ -0,0 +1,113 @@
+// RoadGraph: the graph patched cell by cell in addCell() must match a
+// batch rebuild() of the same road cells, node for node and edge for edge,
+// and its union-find must agree with a flood fill.
+#include <Arduino.h>
+#include <vector>
+#include <algorithm>
+#include <tuple>
+#include "RoadGraph.h"
+#include "check.h"
+
+static const uint16_t W = 30, H = 17;
+
+// Nodes as sorted cells, edges as sorted (end cell, end cell, length)
+static std::vector<uint16_t> nodeCells(const RoadGraph &g) {
+  std::vector<uint16_t> v;
+  for (uint16_t i = 0; i < g.nodeTotal(); i++) v.push_back(g.node(i).cell);
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+static std::vector<std::tuple<uint16_t, uint16_t, uint16_t>> edgeList(const RoadGraph &g) {
+  std::vector<std::tuple<uint16_t, uint16_t, uint16_t>> v;
+  for (uint16_t i = 0; i < g.edgeTotal(); i++) {
+    const RoadGraph::Edge &e = g.edge(i);
+    uint16_t a = g.node(e.a).cell, b = g.node(e.b).cell;
+    v.emplace_back(min(a, b), max(a, b), e.len);
+  }
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+// Components and the biggest one's size by flood fill
+static void floodComponents(const RoadGraph &g, uint16_t &count, uint16_t &largest) {
+  std::vector<uint8_t> seen(W * H, 0);
+  count = largest = 0;
+  for (uint16_t c = 0; c < W * H; c++) {
+    if (seen[c] || !g.isRoad(c % W, c / W)) continue;
+    count++;
+    uint16_t size = 0;
+    std::vector<uint16_t> stack{c};
+    seen[c] = 1;
+    while (!stack.empty()) {
+      uint16_t q = stack.back();
+      stack.pop_back();
+      size++;
+      int x = q % W, y = q / W;
+      const int nb[4][2] = {{x + 1, y}, {x - 1, y}, {x, y + 1}, {x, y - 1}};
+      for (auto &n : nb) {
+        if (n[0] < 0 || n[1] < 0 || n[0] >= W || n[1] >= H) continue;
+        uint16_t r = n[1] * W + n[0];
+        if (!seen[r] && g.isRoad(n[0], n[1])) { seen[r] = 1; stack.push_back(r); }
+      }
+    }
+    largest = max(largest, size);
+  }
+}
+
+static void compare(RoadGraph &inc, const std::vector<uint16_t> &cells) {
+  static RoadGraph batch;
+  static bool ready = batch.init(W, H);
+  CHECK(ready);
+  batch.clear();
+  for (uint16_t c : cells) batch.addCell(c % W, c / W);
+  batch.rebuild();
+
+  CHECK_EQ(inc.nodeTotal(), batch.nodeTotal());
+  CHECK_EQ(inc.edgeTotal(), batch.edgeTotal());
+  CHECK(nodeCells(inc) == nodeCells(batch));
+  CHECK(edgeList(inc) == edgeList(batch));
+  CHECK_EQ(inc.componentCount(), batch.componentCount());
+  CHECK_EQ(inc.largestComponent(), batch.largestComponent());
+
+  uint16_t count, largest;
+  floodComponents(inc, count, largest);
+  CHECK_EQ(inc.componentCount(), count);
+  CHECK_EQ(inc.largestComponent(), largest);
+}
+
+// Mostly random walks (so chains, corners and junctions form), with some
+// scattered cells in between
+static void runSeed(uint32_t seed) {
+  hostRandomSeed(seed);
+  static RoadGraph g;
+  static bool ready = g.init(W, H);
+  CHECK(ready);
+  g.clear();
+
+  std::vector<uint16_t> cells;
+  int16_t x = esp_random() % W, y = esp_random() % H;
+  const uint16_t adds = 150 + esp_random() % 250;
+  for (uint16_t i = 0; i < adds; i++) {
+    if (esp_random() % 8 == 0) {
+      x = esp_random() % W;
+      y = esp_random() % H;
+    } else {
+      switch (esp_random() & 3) {
+        case 0: x = min<int16_t>(W - 1, x + 1); break;
+        case 1: y = min<int16_t>(H - 1, y + 1); break;
+        case 2: x = max<int16_t>(0, x - 1); break;
+        default: y = max<int16_t>(0, y - 1); break;
+      }
+    }
+    if (!g.isRoad(x, y)) cells.push_back(y * W + x);
+    g.addCell(x, y);
+    if (i % 25 == 24) compare(g, cells);
+  }
+  compare(g, cells);
+}
+
+int main() {
+  for (uint32_t seed = 1; seed <= 300; seed++) runSeed(seed * 2654435761u);
+  return checkResult();
+}
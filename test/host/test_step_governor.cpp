@@ -0,0 +1,45 @@
+// StepGovernor against a fake clock: steps cost a fixed time, frames come
+// at a fixed period with half of it as the stepping budget. The sim rate
+// must hold at any frame rate the CPU can afford, and a stall must only
+// cost the time beyond the debt clamp.
+#include <Arduino.h>
+#include "StepGovernor.h"
+#include "check.h"
+
+// Steps run over `seconds` of frames `periodUs` apart
+static uint32_t runFor(StepGovernor &g, uint32_t &clockUs, uint32_t seconds,
+                       uint32_t periodUs, uint32_t stepUs) {
+  uint32_t total = 0;
+  uint32_t frames = seconds * 1000000UL / periodUs;
+  for (uint32_t i = 0; i < frames; i++) {
+    uint16_t steps = g.plan(clockUs, periodUs / 2);
+    g.record(steps, steps * stepUs);
+    CHECK(steps * stepUs <= periodUs / 2 || steps == 1);
+    total += steps;
+    clockUs += periodUs;
+  }
+  return total;
+}
+
+int main() {
+  const uint32_t periods[] = {16667, 33333, 100000};
+  for (uint32_t period : periods) {
+    // 600 steps/s at 300 us a step needs 180 ms a second: fits half of
+    // every frame period
+    StepGovernor g;
+    uint32_t clockUs = 0;
+    g.setRate(600);
+    runFor(g, clockUs, 2, period, 300);        // learn the step cost
+    uint32_t steps = runFor(g, clockUs, 10, period, 300);
+    printf("period %lu us: %lu steps/s\n", (unsigned long)period, (unsigned long)(steps / 10));
+    CHECK(steps >= 5900 && steps <= 6100);
+
+    // a 3 s stall: only what's beyond MAX_BEHIND_US is lost
+    g.setRate(60);
+    runFor(g, clockUs, 2, period, 300);
+    clockUs += 3000000;
+    steps = runFor(g, clockUs, 10, period, 300);
+    CHECK(steps >= 620 && steps <= 635);
+  }
+  return checkResult();
+}
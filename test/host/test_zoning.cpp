@@ -0,0 +1,60 @@
+// Zoning: a bit-sliced generation must equal rule() applied cell by cell
+// with neighbours counted byte by byte. Widths cover both word paths on a
+// 64-bit host (rows of an even and an odd number of 32-bit words) and
+// partly used last words.
+#include <Arduino.h>
+#include <vector>
+#include "Zoning.h"
+#include "check.h"
+
+static void runSeed(uint32_t seed, uint16_t w, uint16_t h, bool withWater) {
+  hostRandomSeed(seed);
+  Zoning z;
+  BitPlane water;
+  CHECK(z.init(w, h) && water.init(w, h));
+  std::vector<uint8_t> a((size_t)w * h), b((size_t)w * h);
+  for (uint16_t y = 0; y < h; y++) {
+    for (uint16_t x = 0; x < w; x++) {
+      uint32_t r = esp_random();
+      if ((r & 31) == 0) z.markRoad(x, y);
+      if (withWater && ((r >> 5) & 31) == 0) water.set(x, y);
+      uint8_t zone = ((r >> 10) % 4) ? (uint8_t)Zoning::ZONE_NONE : 1 + (r >> 12) % 3;
+      z.seed(x, y, zone, 0);
+      a[(size_t)y * w + x] = zone;
+    }
+  }
+
+  for (uint8_t g = 0; g < 12; g++) {
+    for (uint16_t y = 0; y < h; y++) {
+      for (uint16_t x = 0; x < w; x++) {
+        uint8_t n[Zoning::ZONES] = {};
+        for (int dy = -1; dy <= 1; dy++) {
+          for (int dx = -1; dx <= 1; dx++) {
+            int nx = x + dx, ny = y + dy;
+            if ((!dx && !dy) || nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+            n[a[(size_t)ny * w + nx]]++;
+          }
+        }
+        b[(size_t)y * w + x] = Zoning::rule(a[(size_t)y * w + x],
+            n[Zoning::ZONE_RES], n[Zoning::ZONE_COM], n[Zoning::ZONE_IND],
+            z.servedPlane().test(x, y), withWater && water.test(x, y));
+      }
+    }
+    a.swap(b);
+    z.step(withWater ? &water : nullptr);
+
+    uint32_t diff = 0;
+    for (uint16_t y = 0; y < h; y++) {
+      for (uint16_t x = 0; x < w; x++) diff += z.at(x, y) != a[(size_t)y * w + x];
+    }
+    CHECK_EQ(diff, 0u);
+  }
+}
+
+int main() {
+  static const uint16_t SIZES[][2] = {{240, 135}, {64, 40}, {96, 33}, {100, 21}, {31, 17}, {33, 9}};
+  for (auto &s : SIZES) {
+    for (uint32_t seed = 1; seed <= 8; seed++) runSeed(seed * 2654435761u, s[0], s[1], seed & 1);
+  }
+  return checkResult();
+}